@@ -0,0 +1,58 @@
+//===--- FloatArrayLoops.swift --------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// Numeric loops over Float arrays with a trip count which is only known at
+// runtime. Once the bounds checks and the uniqueness check are hoisted out of
+// these loops, they can be unrolled and vectorized.
+
+import TestsUtils
+
+@inline(never)
+func saxpy(_ a: Float, _ x: [Float], _ y: inout [Float]) {
+  for i in 0..<y.count {
+    y[i] = a * x[i] + y[i]
+  }
+}
+
+@inline(never)
+func dot(_ x: [Float], _ y: [Float], _ count: Int) -> Float {
+  var sum: Float = 0
+  for i in 0..<count {
+    sum += x[i] * y[i]
+  }
+  return sum
+}
+
+@inline(never)
+public func run_FloatArraySaxpy(_ N: Int) {
+  let size = 10007
+  let x = [Float](repeating: 1.0, count: size)
+  var y = [Float](repeating: 0.0, count: size)
+  for _ in 1...100*N {
+    saxpy(0.5, x, &y)
+  }
+  CheckResults(y[size - 1] == Float(50 * N),
+               "Incorrect results in FloatArraySaxpy")
+}
+
+@inline(never)
+public func run_FloatArrayDotProduct(_ N: Int) {
+  let size = 10007
+  let x = [Float](repeating: 0.5, count: size)
+  let y = [Float](repeating: 2.0, count: size)
+  var sum: Float = 0
+  for _ in 1...100*N {
+    sum = dot(x, y, size)
+  }
+  CheckResults(sum == Float(size),
+               "Incorrect results in FloatArrayDotProduct: \(sum)")
+}
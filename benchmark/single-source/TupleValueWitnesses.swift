@@ -0,0 +1,70 @@
+//===--- TupleValueWitnesses.swift ----------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// This benchmark tests the value witnesses of tuple types which are
+// instantiated at runtime. The generic functions are not optimized, so that
+// every copy, assignment and destruction of an element goes through the
+// value witness table of the tuple metadata.
+import TestsUtils
+
+class TupleRef {
+  var value: Int
+  init(_ value: Int) { self.value = value }
+}
+
+// Move every element one position towards the front. Each assignment copies
+// an element and assigns it with take.
+@_semantics("optimize.sil.never")
+@inline(never)
+func rotate<T>(_ a: inout [T]) {
+  let first = a[0]
+  for i in 1..<a.count {
+    a[i - 1] = a[i]
+  }
+  a[a.count - 1] = first
+}
+
+// Copy the array element by element and destroy the copy.
+@_semantics("optimize.sil.never")
+@inline(never)
+func copyAndDestroy<T>(_ a: [T]) -> Int {
+  var copy = [T]()
+  copy.reserveCapacity(a.count)
+  for e in a {
+    copy.append(e)
+  }
+  return copy.count
+}
+
+@inline(never)
+func runTupleBenchmark<T>(_ N: Int, _ a: [T]) {
+  var a = a
+  for _ in 1...N {
+    for _ in 0..<10 {
+      rotate(&a)
+    }
+    CheckResults(copyAndDestroy(a) == a.count,
+                 "Incorrect results in TupleValueWitnesses")
+  }
+}
+
+@inline(never)
+public func run_TupleValueWitnessesStringIntDouble(_ N: Int) {
+  let a = (0..<1_000).map { (String($0), $0, Double($0)) }
+  runTupleBenchmark(N, a)
+}
+
+@inline(never)
+public func run_TupleValueWitnessesRefIntRef(_ N: Int) {
+  let a = (0..<1_000).map { (TupleRef($0), $0, TupleRef($0)) }
+  runTupleBenchmark(N, a)
+}
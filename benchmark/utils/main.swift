@@ -48,6 +48,7 @@ import DictionaryRemove
 import DictionarySwap
 import ErrorHandling
 import Fibonacci
+import FloatArrayLoops
 import GlobalClass
 import Hanoi
 import Hash
@@ -98,6 +99,7 @@ import StringInterpolation
 import StringTests
 import StringWalk
 import SuperChars
+import TupleValueWitnesses
 import TwoSum
 import TypeFlood
 import UTF8Decode
@@ -246,6 +248,8 @@ precommitTests = [
   "StringWalk": run_StringWalk,
   "StringWithCString": run_StringWithCString,
   "SuperChars": run_SuperChars,
+  "TupleValueWitnessesRefIntRef": run_TupleValueWitnessesRefIntRef,
+  "TupleValueWitnessesStringIntDouble": run_TupleValueWitnessesStringIntDouble,
   "TwoSum": run_TwoSum,
   "TypeFlood": run_TypeFlood,
   "UTF8Decode": run_UTF8Decode,
@@ -256,6 +260,8 @@ precommitTests = [
 otherTests = [
   "Ackermann": run_Ackermann,
   "Fibonacci": run_Fibonacci,
+  "FloatArrayDotProduct": run_FloatArrayDotProduct,
+  "FloatArraySaxpy": run_FloatArraySaxpy,
 ]
 
 
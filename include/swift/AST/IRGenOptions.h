@@ -161,6 +161,20 @@ public:
   /// Enable use of the swiftcall calling convention.
   unsigned UseSwiftCall : 1;
 
+  /// When optimizing, emit statically initialized metadata for instantiations
+  /// of generic types whose layout and arguments are known at compile time.
+  unsigned EnableGenericMetadataPrespecialization : 1;
+
+  /// If non-empty, a directory in which object files are cached by the hash
+  /// of the LLVM IR they were generated from. If an object file for the same
+  /// IR is found in the cache, the LLVM pipeline is skipped and the cached
+  /// object file is copied to the output.
+  std::string LLVMObjectCachePath;
+
+  /// The maximum size of the object file cache in bytes. When the cache grows
+  /// beyond this size, the least recently used object files are removed.
+  uint64_t LLVMObjectCacheSizeLimit = 1024 * 1024 * 1024;
+
   /// List of backend command-line options for -embed-bitcode.
   std::vector<uint8_t> CmdArgs;
 
@@ -177,7 +191,8 @@ public:
         PrintInlineTree(false), EmbedMode(IRGenEmbedMode::None),
         HasValueNamesSetting(false), ValueNames(false),
         EnableReflectionMetadata(true), EnableReflectionNames(true),
-        UseIncrementalLLVMCodeGen(true), UseSwiftCall(false), CmdArgs(),
+        UseIncrementalLLVMCodeGen(true), UseSwiftCall(false),
+        EnableGenericMetadataPrespecialization(true), CmdArgs(),
         SanitizeCoverage(llvm::SanitizerCoverageOptions()) {}
 
   /// Gets the name of the specified output filename.
@@ -195,6 +210,14 @@ public:
     Hash = (Hash << 1) | Optimize;
     Hash = (Hash << 1) | DisableLLVMOptzns;
     Hash = (Hash << 1) | DisableLLVMARCOpts;
+    Hash = (Hash << 1) | DisableLLVMSLPVectorizer;
+    Hash = (Hash << 1) | DisableFPElim;
+    Hash = (Hash << 2) | static_cast<unsigned>(Sanitize);
+    Hash = (Hash << 3) | static_cast<unsigned>(SanitizeCoverage.CoverageType);
+    Hash = (Hash << 1) | SanitizeCoverage.IndirectCalls;
+    Hash = (Hash << 1) | SanitizeCoverage.TraceBB;
+    Hash = (Hash << 1) | SanitizeCoverage.TraceCmp;
+    Hash = (Hash << 1) | SanitizeCoverage.Use8bitCounters;
     return Hash;
   }
 
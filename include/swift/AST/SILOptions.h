@@ -101,6 +101,15 @@ public:
   /// Emit a mapping of profile counters for use in coverage.
   bool EmitProfileCoverageMapping = false;
 
+  /// The path of the profdata file to use for profile-guided optimization, or
+  /// empty if no profile should be used.
+  std::string UseProfile;
+
+  /// Assume that the module is the whole program, i.e. it is not imported by
+  /// any other module. Only takes effect in whole-module compilation, and
+  /// is rejected when emitting a module or compiling a library.
+  bool WholeProgram = false;
+
   /// Should we use a pass pipeline passed in via a json file? Null by default.
   llvm::StringRef ExternalPassPipelineFilename;
   
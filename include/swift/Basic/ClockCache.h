@@ -0,0 +1,128 @@
+//===--- ClockCache.h - Bounded cache with CLOCK eviction -------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines ClockCache, a map with a fixed capacity. When the cache is
+// full, inserting a new entry evicts an entry which was not looked up
+// recently, using the CLOCK (second-chance) approximation of LRU.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_BASIC_CLOCKCACHE_H
+#define SWIFT_BASIC_CLOCKCACHE_H
+
+#include "swift/Basic/LLVM.h"
+#include "llvm/ADT/DenseMap.h"
+#include <cassert>
+#include <vector>
+
+namespace swift {
+
+/// A map with at most \p Capacity entries which evicts entries with the
+/// CLOCK algorithm.
+///
+/// Each entry has a "referenced" bit which is set when the entry is looked up.
+/// To evict, a clock hand sweeps over the entries, clearing referenced bits,
+/// until it finds an entry whose bit is already clear.
+template <typename KeyT, typename ValueT>
+class ClockCache {
+  struct Entry {
+    KeyT Key;
+    ValueT Value;
+    bool Referenced;
+  };
+
+  /// The cached entries. This vector never grows beyond Capacity.
+  std::vector<Entry> Entries;
+
+  /// Maps keys to indices in Entries.
+  llvm::DenseMap<KeyT, unsigned> KeyToEntry;
+
+  /// The maximum number of entries.
+  unsigned Capacity;
+
+  /// The position of the clock hand in Entries.
+  unsigned Hand = 0;
+
+  unsigned NumHits = 0;
+  unsigned NumMisses = 0;
+  unsigned NumEvictions = 0;
+
+public:
+  explicit ClockCache(unsigned Capacity) : Capacity(Capacity) {
+    assert(Capacity > 0 && "cache must be able to hold an entry");
+  }
+
+  /// Returns the cached value for \p K, or null if it is not in the cache.
+  ///
+  /// The returned pointer is only valid until the next insert.
+  ValueT *lookup(const KeyT &K) {
+    auto Iter = KeyToEntry.find(K);
+    if (Iter == KeyToEntry.end()) {
+      ++NumMisses;
+      return nullptr;
+    }
+    ++NumHits;
+    Entry &E = Entries[Iter->second];
+    E.Referenced = true;
+    return &E.Value;
+  }
+
+  /// Adds or replaces the value for \p K, evicting another entry if the
+  /// cache is full.
+  void insert(const KeyT &K, const ValueT &V) {
+    auto InsertResult = KeyToEntry.insert({K, 0});
+    if (!InsertResult.second) {
+      Entry &E = Entries[InsertResult.first->second];
+      E.Value = V;
+      E.Referenced = true;
+      return;
+    }
+    if (Entries.size() < Capacity) {
+      InsertResult.first->second = Entries.size();
+      Entries.push_back({K, V, false});
+      return;
+    }
+
+    // Give every referenced entry a second chance. This terminates after at
+    // most one full sweep because the bits are cleared on the way.
+    while (Entries[Hand].Referenced) {
+      Entries[Hand].Referenced = false;
+      Hand = (Hand + 1) % Capacity;
+    }
+    Entry &Victim = Entries[Hand];
+    // Note that erasing doesn't invalidate InsertResult: DenseMap only moves
+    // entries when it grows.
+    KeyToEntry.erase(Victim.Key);
+    InsertResult.first->second = Hand;
+    Victim = {K, V, false};
+    Hand = (Hand + 1) % Capacity;
+    ++NumEvictions;
+  }
+
+  /// Removes all entries. The statistics are kept.
+  void clear() {
+    Entries.clear();
+    KeyToEntry.clear();
+    Hand = 0;
+  }
+
+  unsigned size() const { return Entries.size(); }
+  unsigned capacity() const { return Capacity; }
+
+  unsigned getNumHits() const { return NumHits; }
+  unsigned getNumMisses() const { return NumMisses; }
+  unsigned getNumEvictions() const { return NumEvictions; }
+};
+
+} // end namespace swift
+
+#endif // SWIFT_BASIC_CLOCKCACHE_H
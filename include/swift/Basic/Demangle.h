@@ -71,6 +71,106 @@ struct DemangleOptions {
 class Node;
 typedef std::shared_ptr<Node> NodePointer;
 
+/// A bump-pointer arena for demangling trees.
+///
+/// Demangling a symbol creates dozens of small nodes. When an arena is passed
+/// to the demangler, the nodes, their reference counts and their child arrays
+/// are carved out of the arena's slabs instead of being individually
+/// allocated on the heap. Memory is never returned to the arena piecemeal;
+/// instead the arena is recycled as a whole by reset(), which makes it cheap
+/// to reuse one arena for a long sequence of symbols.
+///
+/// Every node allocated from an arena must be destroyed before the arena is
+/// reset or destroyed.
+class NodeArena {
+  struct Slab {
+    Slab *Next;
+    size_t Size;
+
+    char *getStart() { return reinterpret_cast<char *>(this + 1); }
+  };
+
+  /// The list of slabs, in allocation order. Slabs are kept across resets.
+  Slab *FirstSlab = nullptr;
+
+  /// The slab that is currently being allocated from.
+  Slab *CurSlab = nullptr;
+
+  uintptr_t CurPtr = 0;
+  uintptr_t End = 0;
+
+  /// The number of allocations that have not been deallocated yet.
+  size_t NumLiveAllocations = 0;
+
+  void *allocateSlow(size_t size, size_t alignment);
+
+public:
+  NodeArena() = default;
+  NodeArena(const NodeArena &) = delete;
+  NodeArena &operator=(const NodeArena &) = delete;
+  ~NodeArena();
+
+  void *allocate(size_t size, size_t alignment) {
+    ++NumLiveAllocations;
+    uintptr_t ptr = (CurPtr + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    if (CurPtr != 0 && ptr + size <= End) {
+      CurPtr = ptr + size;
+      return reinterpret_cast<void *>(ptr);
+    }
+    return allocateSlow(size, alignment);
+  }
+
+  void deallocate(void *ptr) {
+    assert(NumLiveAllocations > 0 && "deallocating from an empty arena");
+    --NumLiveAllocations;
+  }
+
+  /// Make all memory of the arena available again for new allocations.
+  void reset();
+};
+
+/// An allocator which allocates from a NodeArena, or from the heap if it has
+/// no arena.
+template <typename T>
+class NodeArenaAllocator {
+  NodeArena *Arena;
+
+  template <typename U> friend class NodeArenaAllocator;
+
+public:
+  typedef T value_type;
+
+  NodeArenaAllocator(NodeArena *Arena = nullptr) : Arena(Arena) {}
+
+  template <typename U>
+  NodeArenaAllocator(const NodeArenaAllocator<U> &other)
+    : Arena(other.Arena) {}
+
+  NodeArena *getArena() const { return Arena; }
+
+  T *allocate(size_t n) {
+    if (Arena)
+      return static_cast<T *>(Arena->allocate(n * sizeof(T), alignof(T)));
+    return static_cast<T *>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T *ptr, size_t n) {
+    if (Arena)
+      Arena->deallocate(ptr);
+    else
+      ::operator delete(ptr);
+  }
+
+  template <typename U>
+  bool operator==(const NodeArenaAllocator<U> &other) const {
+    return Arena == other.Arena;
+  }
+  template <typename U>
+  bool operator!=(const NodeArenaAllocator<U> &other) const {
+    return Arena != other.Arena;
+  }
+};
+
 enum class FunctionSigSpecializationParamKind : unsigned {
   // Option Flags use bits 0-5. This give us 6 bits implying 64 entries to
   // work with.
@@ -157,19 +257,21 @@ private:
     IndexType IndexPayload;
   };
 
-  // FIXME: use allocator.
-  typedef std::vector<NodePointer> NodeVector;
+  typedef std::vector<NodePointer, NodeArenaAllocator<NodePointer>> NodeVector;
   NodeVector Children;
 
-  Node(Kind k)
-      : NodeKind(k), NodePayloadKind(PayloadKind::None) {
+  Node(NodeArena *arena, Kind k)
+      : NodeKind(k), NodePayloadKind(PayloadKind::None),
+        Children(NodeArenaAllocator<NodePointer>(arena)) {
   }
-  Node(Kind k, std::string &&t)
-      : NodeKind(k), NodePayloadKind(PayloadKind::Text) {
+  Node(NodeArena *arena, Kind k, std::string &&t)
+      : NodeKind(k), NodePayloadKind(PayloadKind::Text),
+        Children(NodeArenaAllocator<NodePointer>(arena)) {
     new (&TextPayload) std::string(std::move(t));
   }
-  Node(Kind k, IndexType index)
-      : NodeKind(k), NodePayloadKind(PayloadKind::Index) {
+  Node(NodeArena *arena, Kind k, IndexType index)
+      : NodeKind(k), NodePayloadKind(PayloadKind::Index),
+        Children(NodeArenaAllocator<NodePointer>(arena)) {
     IndexPayload = index;
   }
   Node(const Node &) = delete;
@@ -250,6 +352,15 @@ demangleSymbolAsNode(const std::string &mangledName,
   return demangleSymbolAsNode(mangledName.data(), mangledName.size(), options);
 }
 
+/// \brief Demangle the given string as a Swift symbol, allocating the
+/// parse tree from \p arena.
+///
+/// The returned tree must be destroyed before \p arena is reset.
+NodePointer
+demangleSymbolAsNode(const char *mangledName, size_t mangledNameLength,
+                     NodeArena &arena,
+                     const DemangleOptions &options = DemangleOptions());
+
 /// \brief Demangle the given string as a Swift symbol.
 ///
 /// Typical usage:
@@ -352,20 +463,65 @@ std::string nodeToString(NodePointer Root,
 
 struct NodeFactory {
   static NodePointer create(Node::Kind K) {
-    return NodePointer(new Node(K));
+    return NodePointer(new Node(nullptr, K));
   }
   static NodePointer create(Node::Kind K, Node::IndexType Index) {
-    return NodePointer(new Node(K, Index));
+    return NodePointer(new Node(nullptr, K, Index));
   }
   static NodePointer create(Node::Kind K, llvm::StringRef Text) {
-    return NodePointer(new Node(K, Text));
+    return NodePointer(new Node(nullptr, K, Text.str()));
   }
   static NodePointer create(Node::Kind K, std::string &&Text) {
-    return NodePointer(new Node(K, std::move(Text)));
+    return NodePointer(new Node(nullptr, K, std::move(Text)));
   }
   template <size_t N>
   static NodePointer create(Node::Kind K, const char (&Text)[N]) {
-    return NodePointer(new Node(K, llvm::StringRef(Text)));
+    return NodePointer(new Node(nullptr, K, std::string(Text)));
+  }
+
+  /// Variants of the above which allocate the node from \p Arena, or from
+  /// the heap if \p Arena is null.
+  static NodePointer create(NodeArena *Arena, Node::Kind K) {
+    return createIn(Arena, K);
+  }
+  static NodePointer create(NodeArena *Arena, Node::Kind K,
+                            Node::IndexType Index) {
+    return createIn(Arena, K, Index);
+  }
+  static NodePointer create(NodeArena *Arena, Node::Kind K,
+                            llvm::StringRef Text) {
+    return createIn(Arena, K, Text.str());
+  }
+  static NodePointer create(NodeArena *Arena, Node::Kind K,
+                            std::string &&Text) {
+    return createIn(Arena, K, std::move(Text));
+  }
+  template <size_t N>
+  static NodePointer create(NodeArena *Arena, Node::Kind K,
+                            const char (&Text)[N]) {
+    return createIn(Arena, K, std::string(Text));
+  }
+
+private:
+  /// Destroys a node without freeing its memory, which belongs to an arena.
+  struct ArenaNodeDeleter {
+    NodeArena *Arena;
+
+    void operator()(Node *node) const {
+      node->~Node();
+      Arena->deallocate(node);
+    }
+  };
+
+  template <typename... ArgTypes>
+  static NodePointer createIn(NodeArena *Arena, ArgTypes &&... Args) {
+    if (!Arena)
+      return NodePointer(new Node(nullptr, std::forward<ArgTypes>(Args)...));
+
+    void *mem = Arena->allocate(sizeof(Node), alignof(Node));
+    Node *node = new (mem) Node(Arena, std::forward<ArgTypes>(Args)...);
+    return NodePointer(node, ArenaNodeDeleter{Arena},
+                       NodeArenaAllocator<Node>(Arena));
   }
 };
 
@@ -29,6 +29,7 @@ namespace demangle_wrappers {
 using swift::Demangle::Node;
 using swift::Demangle::NodePointer;
 using swift::Demangle::DemangleOptions;
+using swift::Demangle::NodeArena;
 
 class NodeDumper {
   NodePointer Root;
@@ -43,6 +44,10 @@ NodePointer
 demangleSymbolAsNode(StringRef MangledName,
                      const DemangleOptions &Options = DemangleOptions());
 
+NodePointer
+demangleSymbolAsNode(StringRef MangledName, NodeArena &Arena,
+                     const DemangleOptions &Options = DemangleOptions());
+
 std::string nodeToString(NodePointer Root,
                          const DemangleOptions &Options = DemangleOptions());
 
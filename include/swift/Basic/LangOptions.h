@@ -26,6 +26,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Triple.h"
 #include <string>
+#include <vector>
 
 namespace swift {
   /// \brief A collection of options that affect the language dialect and
@@ -124,6 +125,21 @@ namespace swift {
     /// This is for testing purposes.
     std::string DebugForbidTypecheckPrefix;
 
+    /// A specialization requested by a prespecialization manifest.
+    struct PrespecializationRequest {
+      /// The function, e.g. "Array.append(_:)", optionally qualified with the
+      /// module name.
+      std::string Function;
+
+      /// The concrete types of the generic parameters of the function, e.g.
+      /// "Int" or "Swift.Int".
+      SmallVector<std::string, 2> Types;
+    };
+
+    /// Specializations which are emitted as if the functions had
+    /// @_specialize attributes.
+    std::vector<PrespecializationRequest> Prespecializations;
+
     /// Number of parallel processes performing AST verification.
     unsigned ASTVerifierProcessCount = 1U;
 
@@ -2910,6 +2910,21 @@ swift_getGenericMetadata(GenericMetadata *pattern,
                          const void *arguments)
     SWIFT_CC(RegisterPreservingCC);
 
+/// \brief Fetch a uniqued metadata object for a generic value type, using
+/// metadata which was emitted statically by the compiler if the type has
+/// not been instantiated yet.
+///
+/// The candidate must be a complete instantiation of the pattern for the
+/// given arguments, except for its nominal type descriptor, which is filled
+/// in from the pattern. If another image already instantiated or registered
+/// metadata for the same arguments, that metadata is returned and the
+/// candidate is left unused.
+SWIFT_RUNTIME_EXPORT
+extern "C" const Metadata *
+swift_getPrespecializedGenericMetadata(GenericMetadata *pattern,
+                                       const void *arguments,
+                                       ValueMetadata *candidate);
+
 // Callback to allocate a generic class metadata object.
 SWIFT_RUNTIME_EXPORT
 extern "C" ClassMetadata *
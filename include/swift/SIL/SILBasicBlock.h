@@ -45,6 +45,10 @@ private:
   /// The ordered set of instructions in the SILBasicBlock.
   InstListType InstList;
 
+  /// The number of times this block was executed according to profile data,
+  /// or None if no profile count is known.
+  Optional<uint64_t> ProfileCount;
+
   friend struct llvm::ilist_sentinel_traits<SILBasicBlock>;
   friend struct llvm::ilist_traits<SILBasicBlock>;
   SILBasicBlock() : Parent(nullptr) {}
@@ -53,6 +57,10 @@ private:
 
   SILBasicBlock(SILFunction *F, SILBasicBlock *afterBB = nullptr);
 
+  /// Blocks are allocated with SILModule::allocateBlock, so that the memory
+  /// of deleted blocks can be reused.
+  void *operator new(size_t Bytes, SILModule &M);
+
 public:
   ~SILBasicBlock();
 
@@ -74,6 +82,16 @@ public:
   /// Returns true if this BB is the entry BB of its parent.
   bool isEntry() const;
 
+  /// Returns the execution count of this block from profile data, if known.
+  Optional<uint64_t> getProfileCount() const { return ProfileCount; }
+
+  /// Records the execution count of this block from profile data.
+  void setProfileCount(uint64_t Count) { ProfileCount = Count; }
+
+  /// Forgets the execution count of this block, e.g. because a transformation
+  /// distributed its executions over several blocks in an unknown ratio.
+  void clearProfileCount() { ProfileCount = None; }
+
   //===--------------------------------------------------------------------===//
   // SILInstruction List Inspection and Manipulation
   //===--------------------------------------------------------------------===//
@@ -103,9 +121,15 @@ public:
     return const_cast<SILBasicBlock *>(this)->front();
   }
 
-  /// Transfer the instructions from Other to the end of this block.
+  /// Move all instructions of \p Other to the end of this block. This is used
+  /// to merge a block with its single successor, so both blocks are executed
+  /// equally often and the profile count of either one can be kept.
   void spliceAtEnd(SILBasicBlock *Other) {
     InstList.splice(end(), Other->InstList);
+    if (!ProfileCount)
+      ProfileCount = Other->ProfileCount;
+    else if (Other->ProfileCount && *Other->ProfileCount != *ProfileCount)
+      ProfileCount = None;
   }
 
   bool empty() const { return InstList.empty(); }
@@ -342,7 +366,7 @@ public:
   SILBasicBlock *provideInitialHead() const { return createSentinel(); }
   SILBasicBlock *ensureHead(SILBasicBlock*) const { return createSentinel(); }
   static void noteHead(SILBasicBlock*, SILBasicBlock*) {}
-  static void deleteNode(SILBasicBlock *BB) { BB->~SILBasicBlock(); }
+  static void deleteNode(SILBasicBlock *BB);
 
   void addNodeToList(SILBasicBlock *BB) {
   }
@@ -387,6 +387,10 @@ template<typename ImplClass>
 void
 SILCloner<ImplClass>::visitSILBasicBlock(SILBasicBlock* BB) {
   SILFunction &F = getBuilder().getFunction();
+  // When cloning within a function, the executions of the original block are
+  // now split between it and its clone, so its profile count is stale.
+  if (BB->getParent() == &F)
+    BB->clearProfileCount();
   // Iterate over and visit all instructions other than the terminator to clone.
   for (auto I = BB->begin(), E = --BB->end(); I != E; ++I) {
     asImpl().visit(&*I);
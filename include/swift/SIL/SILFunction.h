@@ -152,6 +152,10 @@ private:
   /// It does not include references from debug scopes.
   unsigned RefCount = 0;
 
+  /// The position of this function in the order in which the functions of
+  /// the module were created.
+  unsigned CreationIndex;
+
   /// The function's set of semantics attributes.
   ///
   /// TODO: Why is this using a std::string? Why don't we use uniqued
@@ -277,6 +281,20 @@ public:
   /// Returns true if this function was inlined.
   bool isInlined() const { return Inlined; }
 
+  /// Returns the number of functions which were created in the module before
+  /// this one. Unlike the function's address, the index is never reused for
+  /// another function, so it can tell which functions were created after a
+  /// given point in time.
+  unsigned getCreationIndex() const { return CreationIndex; }
+
+  /// Returns the number of times this function was entered according to
+  /// profile data, if known.
+  Optional<uint64_t> getEntryCount() const {
+    if (empty())
+      return None;
+    return front().getProfileCount();
+  }
+
   /// Mark this function as removed from the module's function list, but kept
   /// as "zombie" for debug info or vtable stub generation.
   void setZombie() {
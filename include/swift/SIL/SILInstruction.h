@@ -4785,6 +4785,11 @@ public:
   SILValue getArgForDestBB(const SILBasicBlock *DestBB,
                            unsigned ArgIndex) const;
 
+  /// Returns the profile execution counts of the true and false edges, or
+  /// None if they cannot be derived from the profile counts of the
+  /// surrounding blocks.
+  Optional<std::pair<uint64_t, uint64_t>> getEdgeCounts() const;
+
   void swapSuccessors();
 
   ArrayRef<Operand> getAllOperands() const { return Operands.asArray(); }
@@ -104,6 +104,12 @@ private:
   /// Allocator that manages the memory of all the pieces of the SILModule.
   mutable llvm::BumpPtrAllocator BPA;
 
+  /// The memory of deleted basic blocks, which is reused for new blocks.
+  /// Each free block stores a pointer to the next one. This needs to be
+  /// declared before \p functions, because blocks are freed while the
+  /// functions are destroyed.
+  void *FreeBlocks = nullptr;
+
   /// The swift Module associated with this SILModule.
   ModuleDecl *TheSwiftModule;
 
@@ -121,6 +127,10 @@ private:
   /// The list of SILFunctions in the module.
   FunctionListType functions;
 
+  /// The number of SILFunctions created in this module so far, including
+  /// deleted ones. See SILFunction::getCreationIndex().
+  unsigned NumFunctionsCreated = 0;
+
   /// Functions, which are dead (and not in the functions list anymore),
   /// but kept alive for debug info generation.
   FunctionListType zombieFunctions;
@@ -294,11 +304,23 @@ public:
     return wholeModule;
   }
 
+  /// Returns true if this SILModule contains the whole module and no other
+  /// module can import it, i.e. the class hierarchies of the module are
+  /// closed even for public and open classes.
+  bool isWholeProgram() const {
+    return wholeModule && Options.WholeProgram;
+  }
+
   SILOptions &getOptions() const { return Options; }
 
   using iterator = FunctionListType::iterator;
   using const_iterator = FunctionListType::const_iterator;
   FunctionListType &getFunctionList() { return functions; }
+
+  /// Returns the creation index which the next new function will get.
+  /// Functions created after this call have an index greater or equal to
+  /// the returned value.
+  unsigned getNextFunctionCreationIndex() const { return NumFunctionsCreated; }
   const FunctionListType &getFunctionList() const { return functions; }
   iterator begin() { return functions.begin(); }
   iterator end() { return functions.end(); }
@@ -592,6 +614,20 @@ public:
   /// Deallocate memory of an instruction.
   void deallocateInst(SILInstruction *I);
 
+  /// Allocate memory for a basic block, reusing the memory of a deleted block
+  /// if possible.
+  void *allocateBlock();
+
+  /// Deallocate memory of a destroyed basic block, so that it can be reused.
+  ///
+  /// Like the address of a deleted instruction, the address of a deleted
+  /// block can be handed out again for a new block.  Maps and sets keyed by
+  /// SILBasicBlock pointers must not outlive the blocks in them, i.e. passes
+  /// must drop erased blocks from them and invalidate analyses with
+  /// InvalidationKind::Branches.  In builds with assertions, the memory of
+  /// a free block is poisoned.
+  void deallocateBlock(SILBasicBlock *BB);
+
   /// \brief Looks up the llvm intrinsic ID and type for the builtin function.
   ///
   /// \returns Returns llvm::Intrinsic::not_intrinsic if the function is not an
@@ -203,6 +203,13 @@ public:
 
 /// A formal SIL reference to a value, suitable for use as a stored
 /// operand.
+///
+/// Operands are stored inline in their instruction, and the uses of a value
+/// form an intrusive doubly-linked list through them. Iterating the uses of
+/// a value therefore touches one operand per user, but never allocates, and
+/// getUser() and getOperandNumber() need no lookup. Bulk updates of a
+/// use-list, like ValueBase::replaceAllUsesWith, should relink the list
+/// directly instead of calling set() on each operand.
 class Operand {
   /// The value used as this operand.
   SILValue TheValue;
@@ -287,6 +294,7 @@ private:
     TheValue->FirstUse = this;
   }
 
+  friend class ValueBase;
   friend class ValueBaseUseIterator;
   friend class ValueUseIterator;
   template <unsigned N> friend class FixedOperandList;
@@ -13,6 +13,7 @@
 #ifndef SWIFT_SILOPTIMIZER_ANALYSIS_ALIASANALYSIS_H
 #define SWIFT_SILOPTIMIZER_ANALYSIS_ALIASANALYSIS_H
 
+#include "swift/Basic/ClockCache.h"
 #include "swift/Basic/ValueEnumerator.h"
 #include "swift/SIL/SILInstruction.h"
 #include "swift/SILOptimizer/Analysis/Analysis.h"
@@ -21,35 +22,6 @@
 
 using swift::RetainObserveKind;
 
-namespace {
-
-  /// A key used for the AliasAnalysis cache.
-  ///
-  /// This struct represents the argument list to the method 'alias'.  The two
-  /// SILValue pointers are mapped to size_t indices because we need an
-  /// efficient way to invalidate them (the mechanism is described below). The
-  /// Type arguments are translated to void* because their underlying storage is
-  /// opaque pointers that never goes away.
-  struct AliasKeyTy {
-    // The SILValue pair:
-    size_t V1, V2;
-    // The TBAAType pair:
-    void *T1, *T2;
-  };
-
-  /// A key used for the MemoryBehavior Analysis cache.
-  ///
-  /// The two SILValue pointers are mapped to size_t indices because we need an
-  /// efficient way to invalidate them (the mechanism is described below).  The
-  /// RetainObserveKind represents the inspection mode for the memory behavior
-  /// analysis.
-  struct MemBehaviorKeyTy {
-    // The SILValue pair:
-    size_t V1, V2;
-    RetainObserveKind InspectionMode; 
-  };
-}
-
 namespace swift {
 
 class SILInstruction;
@@ -102,30 +74,40 @@ private:
   /// never change.
   llvm::DenseMap<TBAACacheKey, bool> TypesMayAliasCache;
 
+  /// A key of the alias and memory behavior caches.
+  ///
+  /// The first element packs the indices of the two queried values into one
+  /// integer. The second element encodes the remaining arguments of the query:
+  /// the indices of the two TBAA types for alias(), or the inspection mode for
+  /// computeMemoryBehavior().
+  using CacheKey = std::pair<uint64_t, uint64_t>;
+
   /// AliasAnalysis value cache.
   ///
   /// The alias() method uses this map to cache queries.
-  llvm::DenseMap<AliasKeyTy, AliasResult> AliasCache;
+  ClockCache<CacheKey, AliasResult> AliasCache;
 
   using MemoryBehavior = SILInstruction::MemoryBehavior;
   /// MemoryBehavior value cache.
   ///
   /// The computeMemoryBehavior() method uses this map to cache queries.
-  llvm::DenseMap<MemBehaviorKeyTy, MemoryBehavior> MemoryBehaviorCache;
+  ClockCache<CacheKey, MemoryBehavior> MemoryBehaviorCache;
 
-  /// The AliasAnalysis cache can't directly map a pair of ValueBase pointers
-  /// to alias results because we'd like to be able to remove deleted pointers
-  /// without having to scan the whole map. So, instead of storing pointers we
-  /// map pointers to indices and store the indices.
-  ValueEnumerator<ValueBase*> AliasValueBaseToIndex;
-  
-  /// Same as AliasValueBaseToIndex, map a pointer to the indices for
-  /// MemoryBehaviorCache.
-  ///
-  /// NOTE: we do not use the same ValueEnumerator for the alias cache, 
-  /// as when either cache is cleared, we can not clear the ValueEnumerator
-  /// because doing so could give rise to collisions in the other cache.
-  ValueEnumerator<ValueBase*> MemoryBehaviorValueBaseToIndex;
+  /// The caches can't directly map pairs of ValueBase pointers to results
+  /// because we'd like to be able to remove deleted pointers without having to
+  /// scan the caches. So, instead of storing pointers we map pointers to
+  /// indices and store the indices. Once a value is forgotten, the cache
+  /// entries which refer to its old index can never be hit again and are
+  /// eventually evicted.
+  ValueEnumerator<ValueBase *, uint32_t> ValueToIndex;
+
+  /// Maps TBAA types to indices for the alias cache keys. Types never go away,
+  /// so this is never invalidated.
+  ValueEnumerator<void *, uint32_t> TBAATypeToIndex;
+
+  /// Packs the indices of \p V1 and \p V2 into the first element of a
+  /// CacheKey.
+  uint64_t toValuePairKey(SILValue V1, SILValue V2);
 
   AliasResult aliasAddressProjection(SILValue V1, SILValue V2,
                                      SILValue O1, SILValue O2);
@@ -142,16 +124,14 @@ private:
     // The pointer I is going away.  We can't scan the whole cache and remove
     // all of the occurrences of the pointer. Instead we remove the pointer
     // from the cache that translates pointers to indices.
-    AliasValueBaseToIndex.invalidateValue(I);
-    MemoryBehaviorValueBaseToIndex.invalidateValue(I);
+    ValueToIndex.invalidateValue(I);
   }
 
   virtual bool needsNotifications() override { return true; }
 
 
 public:
-  AliasAnalysis(SILModule *M) :
-    SILAnalysis(AnalysisKind::Alias), Mod(M), SEA(nullptr), EA(nullptr) {}
+  AliasAnalysis(SILModule *M);
 
   static bool classof(const SILAnalysis *S) {
     return S->getKind() == AnalysisKind::Alias;
@@ -255,23 +235,45 @@ public:
   /// Returns true if \p Ptr may be released by the builtin \p BI.
   bool canBuiltinDecrementRefCount(BuiltinInst *BI, SILValue Ptr);
 
-  /// Encodes the alias query as a AliasKeyTy.
+  /// Encodes the alias query as a CacheKey.
   /// The parameters to this function are identical to the parameters of alias()
   /// and this method serializes them into a key for the alias analysis cache.
-  AliasKeyTy toAliasKey(SILValue V1, SILValue V2, SILType Type1, SILType Type2);
+  CacheKey toAliasKey(SILValue V1, SILValue V2, SILType Type1, SILType Type2);
 
-  /// Encodes the memory behavior query as a MemBehaviorKeyTy.
-  MemBehaviorKeyTy toMemoryBehaviorKey(SILValue V1, SILValue V2, RetainObserveKind K);
+  /// Encodes the memory behavior query as a CacheKey.
+  CacheKey toMemoryBehaviorKey(SILValue V1, SILValue V2, RetainObserveKind K);
+
+  /// Returns the number of alias() queries answered from the cache.
+  unsigned getNumAliasCacheHits() const { return AliasCache.getNumHits(); }
+
+  /// Returns the number of alias() queries which had to be computed.
+  unsigned getNumAliasCacheMisses() const {
+    return AliasCache.getNumMisses();
+  }
+
+  /// Returns the number of computeMemoryBehavior() queries answered from the
+  /// cache.
+  unsigned getNumMemoryBehaviorCacheHits() const {
+    return MemoryBehaviorCache.getNumHits();
+  }
+
+  /// Returns the number of computeMemoryBehavior() queries which had to be
+  /// computed.
+  unsigned getNumMemoryBehaviorCacheMisses() const {
+    return MemoryBehaviorCache.getNumMisses();
+  }
 
   virtual void invalidate(SILAnalysis::InvalidationKind K) override {
     AliasCache.clear();
     MemoryBehaviorCache.clear();
+    ValueToIndex.clear();
   }
 
-  virtual void invalidate(SILFunction *,
-                          SILAnalysis::InvalidationKind K) override {
-    invalidate(K);
-  }
+  /// Forgets the values of \p F. Cached results for other functions are kept:
+  /// they only depend on \p F through its side effects and escape summary,
+  /// which optimizing \p F can only make more precise.
+  virtual void invalidate(SILFunction *F,
+                          SILAnalysis::InvalidationKind K) override;
 };
 
 
@@ -288,55 +290,4 @@ bool isLetPointer(SILValue V);
 
 } // end namespace swift
 
-namespace llvm {
-  template <> struct llvm::DenseMapInfo<AliasKeyTy> {
-    static inline AliasKeyTy getEmptyKey() {
-      auto Allone = std::numeric_limits<size_t>::max();
-      return {0, Allone, nullptr, nullptr};
-    }
-    static inline AliasKeyTy getTombstoneKey() {
-      auto Allone = std::numeric_limits<size_t>::max();
-      return {Allone, 0, nullptr, nullptr};
-    }
-    static unsigned getHashValue(const AliasKeyTy Val) {
-      unsigned H = 0;
-      H ^= DenseMapInfo<size_t>::getHashValue(Val.V1);
-      H ^= DenseMapInfo<size_t>::getHashValue(Val.V2);
-      H ^= DenseMapInfo<void *>::getHashValue(Val.T1);
-      H ^= DenseMapInfo<void *>::getHashValue(Val.T2);
-      return H;
-    }
-    static bool isEqual(const AliasKeyTy LHS, const AliasKeyTy RHS) {
-      return LHS.V1 == RHS.V1 &&
-             LHS.V2 == RHS.V2 &&
-             LHS.T1 == RHS.T1 &&
-             LHS.T2 == RHS.T2;
-    }
-  };
-
-  template <> struct llvm::DenseMapInfo<MemBehaviorKeyTy> {
-    static inline MemBehaviorKeyTy getEmptyKey() {
-      auto Allone = std::numeric_limits<size_t>::max();
-      return {0, Allone, RetainObserveKind::RetainObserveKindEnd};
-    }
-    static inline MemBehaviorKeyTy getTombstoneKey() {
-      auto Allone = std::numeric_limits<size_t>::max();
-      return {Allone, 0, RetainObserveKind::RetainObserveKindEnd};
-    }
-    static unsigned getHashValue(const MemBehaviorKeyTy V) {
-      unsigned H = 0;
-      H ^= DenseMapInfo<size_t>::getHashValue(V.V1);
-      H ^= DenseMapInfo<size_t>::getHashValue(V.V2);
-      H ^= DenseMapInfo<int>::getHashValue(static_cast<int>(V.InspectionMode));
-      return H;
-    }
-    static bool isEqual(const MemBehaviorKeyTy LHS,
-                        const MemBehaviorKeyTy RHS) {
-      return LHS.V1 == RHS.V1 &&
-             LHS.V2 == RHS.V2 &&
-             LHS.InspectionMode == RHS.InspectionMode; 
-    }
-  };
-}
-
 #endif
@@ -222,12 +222,12 @@ protected:
              "already added callees at the begin of visiting a function");
       numVisited++;
       FInfo->StateAndPosition = FunctionInfoBase<FunctionInfo>::Visited;
-      if (FInfo->isValid()) {
-        // Now it's good time to remove invalid caller entries.
-        // Note: we don't have to do this for function which are recomputed.
-        FInfo->removeInvalidCallers();
+      // Now it's good time to remove invalid caller entries. Usually the
+      // caller list of a function which is recomputed is empty, unless it was
+      // invalidated with invalidateOnlyFunction().
+      FInfo->removeInvalidCallers();
+      if (FInfo->isValid())
         return true;
-      }
       InitiallyUnscheduled.push_back(FInfo);
       // Set to valid.
       FInfo->UpdateID = CurrentUpdateID;
@@ -295,6 +295,15 @@ protected:
   /// Returns the ID of the current update-cycle.
   int getCurrentUpdateID() const { return CurrentUpdateID; }
 
+  /// Invalidates only the analysis data of \p FInfo, but not of its callers.
+  /// The list of callers is kept, so that the callers can still be invalidated
+  /// after \p FInfo is recomputed, in case its result changed.
+  template<typename FunctionInfo>
+  void invalidateOnlyFunction(FunctionInfo *FInfo) {
+    FInfo->clear();
+    FInfo->UpdateID = 0;
+  }
+
   /// Invalidates \p FInfo, including all analysis data which depend on it, i.e.
   /// the callers.
   template<typename FunctionInfo>
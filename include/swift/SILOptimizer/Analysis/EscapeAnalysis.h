@@ -18,6 +18,7 @@
 #include "swift/SILOptimizer/Analysis/BasicCalleeAnalysis.h"
 #include "swift/SILOptimizer/Analysis/BottomUpIPAnalysis.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/SmallBitVector.h"
@@ -274,6 +275,7 @@ public:
     friend class CGNodeMap;
     friend class ConnectionGraph;
     friend struct ::CGForDotView;
+    friend class EscapeAnalysis;
 
   public:
     
@@ -598,6 +600,9 @@ public:
 
 private:
 
+  /// A canonical encoding of a summary graph, see computeSummaryFingerprint().
+  typedef llvm::SmallVector<unsigned, 16> SummaryFingerprint;
+
   /// All the information we keep for a function.
   struct FunctionInfo : public FunctionInfoBase<FunctionInfo> {
     FunctionInfo(SILFunction *F) : Graph(F, false), SummaryGraph(F, true) { }
@@ -617,6 +622,11 @@ private:
     /// them again.
     bool NeedUpdateSummaryGraph = true;
 
+    /// The fingerprint of SummaryGraph as it was when it was last computed,
+    /// i.e. of the graph that the callers were built with. It is taken before
+    /// any transformation of the function can modify SummaryGraph.
+    SummaryFingerprint Fingerprint;
+
     /// Clears the analysis data on invalidation.
     void clear() {
       Graph.clear();
@@ -641,6 +651,11 @@ private:
   /// The connection graphs for all functions (does not include external
   /// functions).
   llvm::DenseMap<SILFunction *, FunctionInfo *> Function2Info;
+
+  /// Functions which were invalidated while their callers were kept, mapped
+  /// to the fingerprint of the summary graph which the callers were built
+  /// with. See invalidate(SILFunction *).
+  llvm::MapVector<FunctionInfo *, SummaryFingerprint> PendingInvalidations;
   
   /// The allocator for the connection graphs in Function2ConGraph.
   llvm::SpecificBumpPtrAllocator<FunctionInfo> Allocator;
@@ -717,6 +732,15 @@ private:
   /// all called functions, up to a recursion depth of MaxRecursionDepth.
   void recompute(FunctionInfo *Initial);
 
+  /// Computes an encoding of the summary graph of \p FInfo which only depends
+  /// on the graph's structure. If the fingerprints of two summary graphs are
+  /// equal, merging them into a caller graph has the same effect.
+  void computeSummaryFingerprint(FunctionInfo *FInfo, SummaryFingerprint &FP);
+
+  /// Recomputes the functions in PendingInvalidations. The callers of a
+  /// function are only invalidated if its summary graph changed.
+  void flushPendingInvalidations();
+
   /// Merges the graph of a callee function into the graph of
   /// a caller function, whereas \p FAS is the call-site.
   bool mergeCalleeGraph(SILInstruction *FAS,
@@ -745,6 +769,8 @@ public:
 
   /// Gets the connection graph for \a F.
   ConnectionGraph *getConnectionGraph(SILFunction *F) {
+    if (!PendingInvalidations.empty())
+      flushPendingInvalidations();
     FunctionInfo *FInfo = getFunctionInfo(F);
     if (!FInfo->isValid())
       recompute(FInfo);
@@ -793,6 +819,9 @@ public:
 
   virtual void invalidate(SILFunction *F, InvalidationKind K) override;
 
+  virtual void invalidateForDeadFunction(SILFunction *F,
+                                         InvalidationKind K) override;
+
   virtual void handleDeleteNotification(ValueBase *I) override;
 
   virtual bool needsNotifications() override { return true; }
@@ -15,6 +15,7 @@
 #include "llvm/Support/Casting.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/ErrorHandling.h"
 #include <vector>
@@ -85,6 +86,21 @@ class SILPassManager {
   /// Set to true when a pass invalidates an analysis.
   bool CurrentPassHasInvalidated = false;
 
+  /// Set to true when a module pass invalidates the analyses of the whole
+  /// module, i.e. it did not report which functions it changed.
+  bool CurrentPassHasInvalidatedModule = false;
+
+  /// The functions which were changed or added by the current module pass.
+  /// With -sil-verify-all only these functions are verified after the pass.
+  /// The set may contain stale pointers of functions which were deleted
+  /// without a notification. If such an address is reused by a new function,
+  /// that function is verified anyway, because it was created by the pass.
+  llvm::SmallPtrSet<SILFunction *, 16> ChangedFunctions;
+
+  /// The number of functions which were up for verification with
+  /// -sil-verify-sample-rate so far.
+  unsigned NumVerificationCandidates = 0;
+
   /// True if we need to stop running passes and restart again on the
   /// same function.
   bool RestartPipeline = false;
@@ -132,6 +148,7 @@ public:
         AP->invalidate(K);
 
     CurrentPassHasInvalidated = true;
+    CurrentPassHasInvalidatedModule = true;
 
     // Assume that all functions have changed. Clear all masks of all functions.
     CompletedPassesMap.clear();
@@ -150,6 +167,7 @@ public:
   void notifyAnalysisOfFunction(SILFunction *F) {
     for (auto AP : Analysis)
       AP->notifyAnalysisOfFunction(F);
+    ChangedFunctions.insert(F);
   }
 
   /// \brief Broadcast the invalidation of the function to all analysis.
@@ -161,6 +179,7 @@ public:
         AP->invalidate(F, K);
     
     CurrentPassHasInvalidated = true;
+    ChangedFunctions.insert(F);
     // Any change let all passes run again.
     CompletedPassesMap[F].reset();
   }
@@ -176,6 +195,7 @@ public:
         AP->invalidateForDeadFunction(F, K);
     
     CurrentPassHasInvalidated = true;
+    ChangedFunctions.erase(F);
     // Any change let all passes run again.
     CompletedPassesMap[F].reset();
   }
@@ -190,6 +210,12 @@ public:
   /// D'tor.
   ~SILPassManager();
 
+  /// Returns true if \p F should be verified after the current pass.
+  ///
+  /// With -sil-verify-sample-rate=N only every N-th function which is up for
+  /// verification is actually verified.
+  bool shouldVerify(SILFunction *F);
+
   /// Verify all analyses.
   void verifyAnalyses() const {
     for (auto *A : Analysis) {
@@ -323,7 +323,11 @@ class BaseThreadingCloner : public SILClonerWithScopes<BaseThreadingCloner> {
 
   BaseThreadingCloner(SILFunction &To, SILBasicBlock *From, SILBasicBlock *Dest)
       : SILClonerWithScopes(To, From->getParent() == &To), FromBB(From),
-        DestBB(Dest) {}
+        DestBB(Dest) {
+    // Some executions of From will go through the clone instead.
+    if (From->getParent() == &To)
+      From->clearProfileCount();
+  }
 
   void process(SILInstruction *I) { visit(I); }
 
@@ -403,6 +407,9 @@ class BasicBlockCloner : public BaseThreadingCloner {
         : BaseThreadingCloner(To ? *To->getParent() : *From->getParent(),
                               WithinFunction) {
       FromBB = From;
+      // Some executions of From will go through the clone instead.
+      if (WithinFunction)
+        FromBB->clearProfileCount();
       if (To == nullptr) {
         // Create a new BB that is to be used as a target
         // for cloning.
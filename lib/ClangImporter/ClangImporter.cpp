@@ -733,6 +733,8 @@ ClangImporter::create(ASTContext &ctx,
   importer->Impl.nameImporter.reset(new NameImporter(
       importer->Impl.SwiftContext, importer->Impl.platformAvailability,
       importer->Impl.getClangSema(), importer->Impl.InferImportAsMember));
+  importer->Impl.nameImporter->setModuleLookupTables(
+      importer->Impl.LookupTables);
 
   // Prefer frameworks over plain headers.
   // We add search paths here instead of when building the initial invocation
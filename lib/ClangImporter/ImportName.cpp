@@ -44,6 +44,8 @@
 #define DEBUG_TYPE "Import Name"
 STATISTIC(ImportNameNumCacheHits, "# of times the import name cache was hit");
 STATISTIC(ImportNameNumCacheMisses, "# of times the import name cache was missed");
+STATISTIC(ImportNameNumSerializedHits,
+          "# of import names found in a module's serialized lookup table");
 
 using namespace swift;
 using namespace importer;
@@ -1638,12 +1640,85 @@ Identifier importer::importMacroName(
 ImportedName NameImporter::importName(const clang::NamedDecl *decl,
                                       ImportNameOptions options) {
   CacheKeyType key(decl, options.toRaw());
-  if (importNameCache.count(key)) {
+  auto known = importNameCache.find(key);
+  if (known != importNameCache.end()) {
     ++ImportNameNumCacheHits;
-    return importNameCache[key];
+    return known->second;
   }
   ++ImportNameNumCacheMisses;
+
+  // If the PCM this declaration came from already recorded its name, use
+  // that rather than recomputing it.
+  if (auto serialized = lookupSerializedName(decl, options)) {
+    ++ImportNameNumSerializedHits;
+    importNameCache.insert({key, *serialized});
+    return *serialized;
+  }
+
+  // Note: importNameImpl may recursively import the names of enclosing
+  // contexts, which can grow the cache, so don't hold on to an iterator
+  // across the call.
   auto res = importNameImpl(decl, options);
-  importNameCache[key] = res;
+  importNameCache.insert({key, res});
   return res;
 }
+
+bool NameImporter::canSerializeImportedName(const clang::NamedDecl *decl,
+                                            const ImportedName &name) {
+  if (!name || name.DroppedVariadic || name.ImportAsMember ||
+      name.AccessorKind != ImportedAccessorKind::None ||
+      name.InitKind != CtorInitializerKind::Designated ||
+      name.ErrorInfo || name.SelfIndex)
+    return false;
+
+  // The effective context must be the one the reader can recompute from
+  // the declaration alone.
+  EffectiveClangContext naturalContext(
+    decl->getDeclContext()->getRedeclContext());
+  return name.EffectiveContext.getKind() == EffectiveClangContext::DeclContext &&
+         name.EffectiveContext.getAsDeclContext() ==
+           naturalContext.getAsDeclContext();
+}
+
+void NameImporter::forEachCachedName(
+       llvm::function_ref<void(const clang::NamedDecl *,
+                               const ImportedName &)> fn) {
+  for (const auto &entry : importNameCache) {
+    if (entry.first.getInt() == 0)
+      fn(entry.first.getPointer(), entry.second);
+  }
+}
+
+Optional<ImportedName>
+NameImporter::lookupSerializedName(const clang::NamedDecl *decl,
+                                   ImportNameOptions options) {
+  // Only names computed with the default options are serialized.
+  if (!moduleLookupTables || options.toRaw() != 0 || !decl->isFromASTFile())
+    return None;
+
+  auto clangModule = decl->getImportedOwningModule();
+  if (!clangModule)
+    return None;
+
+  auto known = moduleLookupTables->find(clangModule->getTopLevelModuleName());
+  if (known == moduleLookupTables->end())
+    return None;
+
+  SerializedImportedName serialized;
+  if (!known->second->lookupSerializedName(decl, serialized))
+    return None;
+
+  ImportedName result;
+  Identifier baseName = swiftCtx.getIdentifier(serialized.BaseName);
+  if (serialized.IsCompoundName) {
+    SmallVector<Identifier, 4> argumentNames;
+    for (auto argumentName : serialized.ArgumentNames)
+      argumentNames.push_back(swiftCtx.getIdentifier(argumentName));
+    result.Imported = DeclName(swiftCtx, baseName, argumentNames);
+  } else {
+    result.Imported = baseName;
+  }
+  result.HasCustomName = serialized.HasCustomName;
+  result.EffectiveContext = decl->getDeclContext()->getRedeclContext();
+  return result;
+}
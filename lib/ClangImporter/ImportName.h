@@ -176,6 +176,12 @@ class NameImporter {
   /// Cache for repeated calls
   llvm::DenseMap<CacheKeyType, ImportedName> importNameCache;
 
+  /// The lookup tables of the loaded Clang modules, keyed by top-level
+  /// module name. Names that were computed when a module's PCM was built
+  /// are serialized in its table and reused instead of being recomputed.
+  const llvm::StringMap<std::unique_ptr<SwiftLookupTable>> *moduleLookupTables
+    = nullptr;
+
 public:
   NameImporter(ASTContext &ctx, const PlatformAvailability &avail,
                clang::Sema &cSema, bool inferIAM)
@@ -187,6 +193,24 @@ public:
   ImportedName importName(const clang::NamedDecl *decl,
                           ImportNameOptions options);
 
+  /// Reuse the names serialized in the lookup tables of loaded Clang
+  /// modules.
+  void setModuleLookupTables(
+         const llvm::StringMap<std::unique_ptr<SwiftLookupTable>> &tables) {
+    moduleLookupTables = &tables;
+  }
+
+  /// Whether the name computed for \p decl with the default options is
+  /// fully described by a \c SerializedImportedName, and so can be stored
+  /// in a module's lookup table.
+  static bool canSerializeImportedName(const clang::NamedDecl *decl,
+                                       const ImportedName &name);
+
+  /// Visit each name computed so far with the default options.
+  void forEachCachedName(
+         llvm::function_ref<void(const clang::NamedDecl *,
+                                 const ImportedName &)> fn);
+
   ASTContext &getContext() { return swiftCtx; }
   const LangOptions &getLangOpts() const { return swiftCtx.LangOpts; }
 
@@ -244,6 +268,11 @@ private:
 
   ImportedName importNameImpl(const clang::NamedDecl *,
                               ImportNameOptions options);
+
+  /// Look for the name of \p decl in the lookup table of the module it was
+  /// deserialized from.
+  Optional<ImportedName> lookupSerializedName(const clang::NamedDecl *decl,
+                                              ImportNameOptions options);
 };
 
 }
@@ -25,6 +25,7 @@
 #include "clang/Serialization/ASTBitCodes.h"
 #include "clang/Serialization/ASTReader.h"
 #include "clang/Serialization/ASTWriter.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringExtras.h"
@@ -148,17 +149,20 @@ class SwiftLookupTableReader : public clang::ModuleFileExtensionReader {
   void *SerializedTable;
   ArrayRef<clang::serialization::DeclID> Categories;
   void *GlobalsAsMembersTable;
+  void *ImportedNamesTable;
 
   SwiftLookupTableReader(clang::ModuleFileExtension *extension,
                          clang::ASTReader &reader,
                          clang::serialization::ModuleFile &moduleFile,
                          std::function<void()> onRemove, void *serializedTable,
                          ArrayRef<clang::serialization::DeclID> categories,
-                         void *globalsAsMembersTable)
+                         void *globalsAsMembersTable,
+                         void *importedNamesTable)
       : ModuleFileExtensionReader(extension), Reader(reader),
         ModuleFile(moduleFile), OnRemove(onRemove),
         SerializedTable(serializedTable), Categories(categories),
-        GlobalsAsMembersTable(globalsAsMembersTable) {}
+        GlobalsAsMembersTable(globalsAsMembersTable),
+        ImportedNamesTable(importedNamesTable) {}
 
 public:
   /// Create a new lookup table reader for the given AST reader and stream
@@ -200,6 +204,13 @@ public:
   /// \returns true if we found anything, false otherwise.
   bool lookupGlobalsAsMembers(SwiftLookupTable::StoredContext context,
                               SmallVectorImpl<uintptr_t> &entries);
+
+  /// Retrieve the Swift name computed for the declaration with the given
+  /// ID when the module was built.
+  ///
+  /// \returns true if we found anything, false otherwise.
+  bool lookupImportedName(clang::serialization::DeclID declID,
+                          SerializedImportedName &result);
 };
 }
 
@@ -888,7 +899,11 @@ namespace {
 
     /// Record that contains the mapping from contexts to the list of
     /// globals that will be injected as members into those contexts.
-    GLOBALS_AS_MEMBERS_RECORD_ID
+    GLOBALS_AS_MEMBERS_RECORD_ID,
+
+    /// Record that contains the mapping from declaration IDs to the Swift
+    /// names computed for them when the module was built.
+    IMPORTED_NAMES_RECORD_ID
   };
 
   using BaseNameToEntitiesTableRecordLayout
@@ -900,6 +915,9 @@ namespace {
   using GlobalsAsMembersTableRecordLayout
     = BCRecordLayout<GLOBALS_AS_MEMBERS_RECORD_ID, BCVBR<16>, BCBlob>;
 
+  using ImportedNamesTableRecordLayout
+    = BCRecordLayout<IMPORTED_NAMES_RECORD_ID, BCVBR<16>, BCBlob>;
+
   /// Trait used to write the on-disk hash table for the base name -> entities
   /// mapping.
   class BaseNameToEntitiesTableWriterInfo {
@@ -1063,6 +1081,74 @@ namespace {
       }
     }
   };
+
+  /// Trait used to write the on-disk hash table for the declaration ID ->
+  /// imported name mapping.
+  class ImportedNamesTableWriterInfo {
+  public:
+    using key_type = clang::serialization::DeclID;
+    using key_type_ref = key_type;
+    using data_type = DeclName;
+    using data_type_ref = const data_type &;
+    using hash_value_type = uint32_t;
+    using offset_type = unsigned;
+
+    /// The declarations whose names came from a swift_name attribute.
+    llvm::DenseSet<clang::serialization::DeclID> HasCustomName;
+
+    hash_value_type ComputeHash(key_type_ref key) {
+      return llvm::hash_value(key);
+    }
+
+    std::pair<unsigned, unsigned> EmitKeyDataLength(raw_ostream &out,
+                                                    key_type_ref key,
+                                                    data_type_ref data) {
+      uint32_t keyLength = sizeof(clang::serialization::DeclID);
+
+      // Flags, base name and # of arguments.
+      uint32_t dataLength = 1 + sizeof(uint16_t) +
+                            data.getBaseName().str().size() +
+                            sizeof(uint16_t);
+
+      // Argument names.
+      for (auto argName : data.getArgumentNames())
+        dataLength += sizeof(uint16_t) + argName.str().size();
+
+      endian::Writer<little> writer(out);
+      writer.write<uint16_t>(keyLength);
+      writer.write<uint16_t>(dataLength);
+      return { keyLength, dataLength };
+    }
+
+    void EmitKey(raw_ostream &out, key_type_ref key, unsigned len) {
+      endian::Writer<little> writer(out);
+      writer.write<uint32_t>(key);
+    }
+
+    void EmitData(raw_ostream &out, key_type_ref key, data_type_ref data,
+                  unsigned len) {
+      endian::Writer<little> writer(out);
+
+      // Flags.
+      uint8_t flags = 0;
+      if (data.isCompoundName())
+        flags |= 0x01;
+      if (HasCustomName.count(key))
+        flags |= 0x02;
+      writer.write<uint8_t>(flags);
+
+      // Base name.
+      writer.write<uint16_t>(data.getBaseName().str().size());
+      out << data.getBaseName().str();
+
+      // Argument names.
+      writer.write<uint16_t>(data.getArgumentNames().size());
+      for (auto argName : data.getArgumentNames()) {
+        writer.write<uint16_t>(argName.str().size());
+        out << argName.str();
+      }
+    }
+  };
 }
 
 void SwiftLookupTableWriter::writeExtensionContents(
@@ -1144,6 +1230,53 @@ void SwiftLookupTableWriter::writeExtensionContents(
     GlobalsAsMembersTableRecordLayout layout(stream);
     layout.emit(ScratchRecord, tableOffset, hashTableBlob);
   }
+
+  // Write the names computed for this module's declarations, so that
+  // importers of the module don't have to compute them again.
+  {
+    ImportedNamesTableWriterInfo info;
+    SmallVector<std::pair<clang::serialization::DeclID, DeclName>, 64> names;
+    nameImporter.forEachCachedName(
+      [&](const clang::NamedDecl *decl, const ImportedName &name) {
+        if (decl->isFromASTFile() ||
+            !NameImporter::canSerializeImportedName(decl, name))
+          return;
+
+        auto declID = Writer.getDeclID(decl);
+        names.push_back({declID, name.Imported});
+        if (name.HasCustomName)
+          info.HasCustomName.insert(declID);
+      });
+
+    if (!names.empty()) {
+      // Sort by ID so the table doesn't depend on the cache's hash order.
+      llvm::array_pod_sort(names.begin(), names.end(),
+                           [](const std::pair<clang::serialization::DeclID,
+                                              DeclName> *lhs,
+                              const std::pair<clang::serialization::DeclID,
+                                              DeclName> *rhs) -> int {
+                             if (lhs->first == rhs->first) return 0;
+                             return lhs->first < rhs->first ? -1 : 1;
+                           });
+
+      llvm::SmallString<4096> hashTableBlob;
+      uint32_t tableOffset;
+      {
+        llvm::OnDiskChainedHashTableGenerator<ImportedNamesTableWriterInfo>
+          generator;
+        for (const auto &entry : names)
+          generator.insert(entry.first, entry.second, info);
+
+        llvm::raw_svector_ostream blobStream(hashTableBlob);
+        // Make sure that no bucket is at offset 0
+        endian::Writer<little>(blobStream).write<uint32_t>(0);
+        tableOffset = generator.Emit(blobStream, info);
+      }
+
+      ImportedNamesTableRecordLayout layout(stream);
+      layout.emit(ScratchRecord, tableOffset, hashTableBlob);
+    }
+  }
 }
 
 namespace {
@@ -1277,7 +1410,76 @@ namespace {
   };
 }
 
+namespace {
+  /// Used to deserialize the on-disk declaration ID -> imported name table.
+  class ImportedNamesTableReaderInfo {
+  public:
+    using internal_key_type = clang::serialization::DeclID;
+    using external_key_type = internal_key_type;
+    using data_type = SerializedImportedName;
+    using hash_value_type = uint32_t;
+    using offset_type = unsigned;
+
+    internal_key_type GetInternalKey(external_key_type key) {
+      return key;
+    }
+
+    external_key_type GetExternalKey(internal_key_type key) {
+      return key;
+    }
+
+    hash_value_type ComputeHash(internal_key_type key) {
+      return llvm::hash_value(key);
+    }
+
+    static bool EqualKey(internal_key_type lhs, internal_key_type rhs) {
+      return lhs == rhs;
+    }
+
+    static std::pair<unsigned, unsigned>
+    ReadKeyDataLength(const uint8_t *&data) {
+      unsigned keyLength = endian::readNext<uint16_t, little, unaligned>(data);
+      unsigned dataLength = endian::readNext<uint16_t, little, unaligned>(data);
+      return { keyLength, dataLength };
+    }
+
+    static internal_key_type ReadKey(const uint8_t *data, unsigned length) {
+      return endian::readNext<uint32_t, little, unaligned>(data);
+    }
+
+    static data_type ReadData(internal_key_type key, const uint8_t *data,
+                              unsigned length) {
+      data_type result;
+
+      // Flags.
+      uint8_t flags = endian::readNext<uint8_t, little, unaligned>(data);
+      result.IsCompoundName = flags & 0x01;
+      result.HasCustomName = flags & 0x02;
+
+      // Base name.
+      uint16_t baseNameLength =
+        endian::readNext<uint16_t, little, unaligned>(data);
+      result.BaseName = StringRef((const char *)data, baseNameLength);
+      data += baseNameLength;
+
+      // Argument names.
+      unsigned numArgs = endian::readNext<uint16_t, little, unaligned>(data);
+      while (numArgs--) {
+        uint16_t argLength = endian::readNext<uint16_t, little, unaligned>(data);
+        result.ArgumentNames.push_back(StringRef((const char *)data,
+                                                 argLength));
+        data += argLength;
+      }
+
+      return result;
+    }
+  };
+}
+
 namespace swift {
+  using SerializedImportedNamesTable =
+    llvm::OnDiskChainedHashTable<ImportedNamesTableReaderInfo>;
+
   using SerializedBaseNameToEntitiesTable =
     llvm::OnDiskIterableChainedHashTable<BaseNameToEntitiesTableReaderInfo>;
 
@@ -1338,6 +1540,7 @@ SwiftLookupTableReader::~SwiftLookupTableReader() {
   OnRemove();
   delete static_cast<SerializedBaseNameToEntitiesTable *>(SerializedTable);
   delete static_cast<SerializedGlobalsAsMembersTable *>(GlobalsAsMembersTable);
+  delete static_cast<SerializedImportedNamesTable *>(ImportedNamesTable);
 }
 
 std::unique_ptr<SwiftLookupTableReader>
@@ -1353,6 +1556,7 @@ SwiftLookupTableReader::create(clang::ModuleFileExtension *extension,
   auto next = cursor.advance();
   std::unique_ptr<SerializedBaseNameToEntitiesTable> serializedTable;
   std::unique_ptr<SerializedGlobalsAsMembersTable> globalsAsMembersTable;
+  std::unique_ptr<SerializedImportedNamesTable> importedNamesTable;
   ArrayRef<clang::serialization::DeclID> categories;
   while (next.Kind != llvm::BitstreamEntry::EndBlock) {
     if (next.Kind == llvm::BitstreamEntry::Error)
@@ -1416,6 +1620,20 @@ SwiftLookupTableReader::create(clang::ModuleFileExtension *extension,
       break;
     }
 
+    case IMPORTED_NAMES_RECORD_ID: {
+      // Already saw imported names table.
+      if (importedNamesTable)
+        return nullptr;
+
+      uint32_t tableOffset;
+      ImportedNamesTableRecordLayout::readRecord(scratch, tableOffset);
+      auto base = reinterpret_cast<const uint8_t *>(blobData.data());
+
+      importedNamesTable.reset(
+        SerializedImportedNamesTable::Create(base + tableOffset, base));
+      break;
+    }
+
     default:
       // Unknown record, possibly for use by a future version of the
       // module format.
@@ -1431,7 +1649,8 @@ SwiftLookupTableReader::create(clang::ModuleFileExtension *extension,
   return std::unique_ptr<SwiftLookupTableReader>(
            new SwiftLookupTableReader(extension, reader, moduleFile, onRemove,
                                       serializedTable.release(), categories,
-                                      globalsAsMembersTable.release()));
+                                      globalsAsMembersTable.release(),
+                                      importedNamesTable.release()));
 
 }
 
@@ -1488,6 +1707,36 @@ bool SwiftLookupTableReader::lookupGlobalsAsMembers(
   return true;
 }
 
+bool SwiftLookupTableReader::lookupImportedName(
+       clang::serialization::DeclID declID,
+       SerializedImportedName &result) {
+  auto table =
+    static_cast<SerializedImportedNamesTable*>(ImportedNamesTable);
+  if (!table) return false;
+
+  auto known = table->find(declID);
+  if (known == table->end()) return false;
+
+  result = *known;
+  return true;
+}
+
+bool SwiftLookupTable::lookupSerializedName(const clang::NamedDecl *decl,
+                                            SerializedImportedName &result) {
+  if (!Reader || !decl->isFromASTFile())
+    return false;
+
+  // The table only describes declarations from its own module file.
+  auto &astReader = Reader->getASTReader();
+  auto &moduleFile = Reader->getModuleFile();
+  if (astReader.getOwningModuleFile(decl) != &moduleFile)
+    return false;
+
+  auto localID = astReader.mapGlobalIDToModuleFileGlobalID(
+                   moduleFile, decl->getGlobalID());
+  return Reader->lookupImportedName(localID, result);
+}
+
 clang::ModuleFileExtensionMetadata
 SwiftNameLookupExtension::getExtensionMetadata() const {
   clang::ModuleFileExtensionMetadata metadata;
@@ -1501,10 +1750,20 @@ SwiftNameLookupExtension::getExtensionMetadata() const {
 
 llvm::hash_code
 SwiftNameLookupExtension::hashExtension(llvm::hash_code code) const {
-  return llvm::hash_combine(code, StringRef("swift.lookup"),
+  code = llvm::hash_combine(code, StringRef("swift.lookup"),
                             SWIFT_LOOKUP_TABLE_VERSION_MAJOR,
                             SWIFT_LOOKUP_TABLE_VERSION_MINOR,
                             inferImportAsMember);
+
+  // The serialized names depend on the options the names were computed
+  // with, so don't share a module file between different configurations.
+  const auto &langOpts = swiftCtx.LangOpts;
+  for (unsigned i = 0, n = langOpts.EffectiveLanguageVersion.size(); i != n;
+       ++i)
+    code = llvm::hash_combine(code, langOpts.EffectiveLanguageVersion[i]);
+  return llvm::hash_combine(code, langOpts.EnableObjCInterop,
+                            StringRef(
+                              availability.deprecatedAsUnavailableMessage));
 }
 
 void SwiftLookupTableWriter::populateTable(SwiftLookupTable &table,
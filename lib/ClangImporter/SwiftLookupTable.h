@@ -139,6 +139,24 @@ public:
 class SwiftLookupTableReader;
 class SwiftLookupTableWriter;
 
+/// The Swift name of a Clang declaration as stored in a serialized lookup
+/// table. Only names that are imported into the declaration's own
+/// redeclaration context, without any of the accessor, initializer or
+/// error-handling adjustments, are stored.
+struct SerializedImportedName {
+  /// The base name.
+  StringRef BaseName;
+
+  /// The argument labels, if this is a compound name.
+  SmallVector<StringRef, 4> ArgumentNames;
+
+  /// Whether this is a compound name, i.e. has an argument list.
+  bool IsCompoundName = false;
+
+  /// Whether the name came from a swift_name attribute.
+  bool HasCustomName = false;
+};
+
 /// Lookup table major version number.
 ///
 const uint16_t SWIFT_LOOKUP_TABLE_VERSION_MAJOR = 1;
@@ -146,7 +164,7 @@ const uint16_t SWIFT_LOOKUP_TABLE_VERSION_MAJOR = 1;
 /// Lookup table minor version number.
 ///
 /// When the format changes IN ANY WAY, this number should be incremented.
-const uint16_t SWIFT_LOOKUP_TABLE_VERSION_MINOR = 14; // Swift 2 names
+const uint16_t SWIFT_LOOKUP_TABLE_VERSION_MINOR = 15; // Imported names
 
 /// A lookup table that maps Swift names to the set of Clang
 /// declarations with that particular name.
@@ -391,6 +409,13 @@ public:
   /// imported as members.
   SmallVector<SingleEntry, 4> allGlobalsAsMembers();
 
+  /// Look up the Swift name that was computed for \p decl when this table
+  /// was serialized.
+  ///
+  /// \returns true if a name was found, false otherwise.
+  bool lookupSerializedName(const clang::NamedDecl *decl,
+                            SerializedImportedName &result);
+
   /// Deserialize all entries.
   void deserializeAll();
 
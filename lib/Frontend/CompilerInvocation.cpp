@@ -92,6 +92,71 @@ static void debugFailWithCrash() {
   LLVM_BUILTIN_TRAP;
 }
 
+/// Returns true if \p Name is a possibly module-qualified type name.
+static bool isPrespecializationTypeName(StringRef Name) {
+  SmallVector<StringRef, 2> Components;
+  Name.split(Components, '.');
+  for (StringRef Component : Components) {
+    if (Component.empty() || isdigit((unsigned char)Component[0]))
+      return false;
+    for (char C : Component) {
+      if (!isalnum((unsigned char)C) && C != '_')
+        return false;
+    }
+  }
+  return true;
+}
+
+/// Read a prespecialization manifest.
+///
+/// Each line has the form "<function> : <type>, ...". Empty lines and lines
+/// starting with '#' are ignored.
+///
+/// Returns false on error.
+static bool readPrespecializationManifest(
+    DiagnosticEngine &diags, StringRef path,
+    std::vector<LangOptions::PrespecializationRequest> &requests) {
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer =
+      llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    diags.diagnose(SourceLoc(), diag::cannot_open_file, path,
+                   buffer.getError().message());
+    return false;
+  }
+
+  for (llvm::line_iterator line(*buffer.get(), /*SkipBlanks=*/true,
+                                /*CommentMarker=*/'#');
+       !line.is_at_eof(); ++line) {
+    // The function name itself may contain colons, e.g. "append(_:)".
+    StringRef function, types;
+    std::tie(function, types) = line->rsplit(':');
+    function = function.trim();
+    types = types.trim();
+
+    LangOptions::PrespecializationRequest request;
+    request.Function = function;
+    SmallVector<StringRef, 2> typeNames;
+    types.split(typeNames, ',');
+    for (StringRef typeName : typeNames) {
+      typeName = typeName.trim();
+      if (!isPrespecializationTypeName(typeName)) {
+        request.Types.clear();
+        break;
+      }
+      request.Types.push_back(typeName);
+    }
+
+    if (function.empty() || request.Types.empty()) {
+      diags.diagnose(SourceLoc(),
+                     diag::error_malformed_prespecialization_manifest, path,
+                     unsigned(line.line_number()));
+      return false;
+    }
+    requests.push_back(std::move(request));
+  }
+  return true;
+}
+
 /// Try to read a file list file.
 ///
 /// Returns false on error.
@@ -869,6 +934,12 @@ static bool ParseLangArgs(LangOptions &Opts, ArgList &Args,
     Opts.DebugForbidTypecheckPrefix = A->getValue();
   }
 
+  if (const Arg *A = Args.getLastArg(OPT_prespecialization_manifest)) {
+    if (!readPrespecializationManifest(Diags, A->getValue(),
+                                       Opts.Prespecializations))
+      return true;
+  }
+
   if (const Arg *A = Args.getLastArg(OPT_solver_memory_threshold)) {
     unsigned threshold;
     if (StringRef(A->getValue()).getAsInteger(10, threshold)) {
@@ -1147,6 +1218,23 @@ static bool ParseSILArgs(SILOptions &Opts, ArgList &Args,
 
   Opts.GenerateProfile |= Args.hasArg(OPT_profile_generate);
   Opts.EmitProfileCoverageMapping |= Args.hasArg(OPT_profile_coverage_mapping);
+  if (const Arg *A = Args.getLastArg(OPT_profile_use))
+    Opts.UseProfile = A->getValue();
+  Opts.WholeProgram |= Args.hasArg(OPT_whole_program);
+  if (Opts.WholeProgram) {
+    // Closing the class hierarchies is only sound if no other module can
+    // import this one and subclass its open classes.
+    if (!FEOpts.ModuleOutputPath.empty()) {
+      Diags.diagnose(SourceLoc(),
+                     diag::error_whole_program_requires_executable, 0);
+      return true;
+    }
+    if (FEOpts.InputKind == InputFileKind::IFK_Swift_Library) {
+      Diags.diagnose(SourceLoc(),
+                     diag::error_whole_program_requires_executable, 1);
+      return true;
+    }
+  }
   Opts.EnableGuaranteedClosureContexts |=
     Args.hasArg(OPT_enable_guaranteed_closure_contexts);
   Opts.DisableSILPartialApply |=
@@ -1311,6 +1399,17 @@ static bool ParseIRGenArgs(IRGenOptions &Opts, ArgList &Args,
   Opts.UseIncrementalLLVMCodeGen &=
     !Args.hasArg(OPT_disable_incremental_llvm_codegeneration);
 
+  Opts.LLVMObjectCachePath = Args.getLastArgValue(OPT_llvm_object_cache_path);
+  if (const Arg *A = Args.getLastArg(OPT_llvm_object_cache_size_limit)) {
+    uint64_t limit;
+    if (StringRef(A->getValue()).getAsInteger(10, limit)) {
+      Diags.diagnose(SourceLoc(), diag::error_invalid_arg_value,
+                     A->getAsString(Args), A->getValue());
+      return true;
+    }
+    Opts.LLVMObjectCacheSizeLimit = limit * 1024 * 1024;
+  }
+
   if (Args.hasArg(OPT_embed_bitcode))
     Opts.EmbedMode = IRGenEmbedMode::EmbedBitcode;
   else if (Args.hasArg(OPT_embed_bitcode_marker))
@@ -1358,6 +1457,10 @@ static bool ParseIRGenArgs(IRGenOptions &Opts, ArgList &Args,
     Opts.EnableReflectionNames = false;
   }
 
+  if (Args.hasArg(OPT_disable_generic_metadata_prespecialization)) {
+    Opts.EnableGenericMetadataPrespecialization = false;
+  }
+
   for (const auto &Lib : Args.getAllArgValues(options::OPT_autolink_library))
     Opts.LinkLibraries.push_back(LinkLibrary(Lib, LibraryKind::Library));
 
@@ -638,6 +638,97 @@ static llvm::Value *stackPromote(IRGenFunction &IGF,
   return Alloca.getAddress();
 }
 
+/// Try to allocate a class instance with a tail-allocated array, whose count is
+/// only known at runtime, in a stack buffer of a fixed size.
+///
+/// The count is checked at runtime and the object is allocated on the heap if
+/// it doesn't fit into the buffer. Returns the allocated object and sets
+/// \p StackBuffer if successful, or returns nullptr otherwise.
+static llvm::Value *
+emitConditionalStackAllocation(IRGenFunction &IGF,
+                               const StructLayout &ClassLayout,
+                               llvm::Value *metadata, llvm::Value *size,
+                               llvm::Value *alignMask, int &StackAllocSize,
+                               TailArraysRef TailArrays,
+                               llvm::Value *&StackBuffer) {
+  if (StackAllocSize < 0)
+    return nullptr;
+  if (!ClassLayout.isFixedLayout())
+    return nullptr;
+
+  // Arrays have a single tail-allocated array. Constant counts are handled by
+  // stackPromote().
+  if (TailArrays.size() != 1)
+    return nullptr;
+  SILType ElemTy = TailArrays[0].first;
+  llvm::Value *Count = TailArrays[0].second;
+  if (isa<llvm::ConstantInt>(Count))
+    return nullptr;
+
+  const TypeInfo &ElemTI = IGF.getTypeInfo(ElemTy);
+  if (!ElemTI.isFixedSize())
+    return nullptr;
+  const FixedTypeInfo &ElemFTI = ElemTI.as<FixedTypeInfo>();
+  Alignment ClassAlign = ClassLayout.getAlignment();
+  Alignment ElemAlign = ElemFTI.getFixedAlignment();
+  if (ElemAlign > ClassAlign)
+    return nullptr;
+  Size Stride = ElemFTI.getFixedStride();
+  if (Stride.isZero())
+    return nullptr;
+
+  // The buffer is reserved even if the object ends up on the heap. Therefore
+  // only a part of the stack promotion limit is used for it.
+  int Limit = std::min(StackAllocSize,
+                       int(IGF.IGM.IRGen.Opts.StackPromotionSizeLimit / 4));
+  Size HeaderSize = ClassLayout.getSize().roundUpToAlignment(ElemAlign);
+  if (HeaderSize >= Size(Limit))
+    return nullptr;
+  uint64_t MaxCount = (Size(Limit) - HeaderSize).getValue() / Stride.getValue();
+  if (MaxCount == 0)
+    return nullptr;
+  Size BufferSize = HeaderSize + Stride * MaxCount;
+
+  llvm::Value *BufferSizeVal = llvm::ConstantInt::get(IGF.IGM.Int32Ty,
+                                                      BufferSize.getValue());
+  Address Buffer = IGF.createAlloca(IGF.IGM.Int8Ty, BufferSizeVal, ClassAlign,
+                                    "reference.buffer");
+
+  auto *StackBB = IGF.createBasicBlock("stack.alloc");
+  auto *HeapBB = IGF.createBasicBlock("heap.alloc");
+  auto *ContBB = IGF.createBasicBlock("alloc.cont");
+
+  // The comparison is unsigned, so that invalid negative counts take the same
+  // path as without stack promotion.
+  llvm::Value *Fits = IGF.Builder.CreateICmpULE(
+      Count, llvm::ConstantInt::get(Count->getType(), MaxCount));
+  IGF.Builder.CreateCondBr(Fits, StackBB, HeapBB);
+
+  IGF.Builder.emitBlock(StackBB);
+  llvm::Value *StackObject =
+      IGF.Builder.CreateBitCast(Buffer.getAddress(), IGF.IGM.RefCountedPtrTy);
+  StackObject = IGF.emitInitStackObjectCall(metadata, StackObject,
+                                            "reference.new");
+  llvm::BasicBlock *StackEndBB = IGF.Builder.GetInsertBlock();
+  IGF.Builder.CreateBr(ContBB);
+
+  IGF.Builder.emitBlock(HeapBB);
+  size = appendSizeForTailAllocatedArrays(IGF, size, TailArrays);
+  llvm::Value *HeapObject = IGF.emitAllocObjectCall(metadata, size, alignMask,
+                                                    "reference.new");
+  llvm::BasicBlock *HeapEndBB = IGF.Builder.GetInsertBlock();
+  IGF.Builder.CreateBr(ContBB);
+
+  IGF.Builder.emitBlock(ContBB);
+  auto *Phi = IGF.Builder.CreatePHI(IGF.IGM.RefCountedPtrTy, 2);
+  Phi->addIncoming(StackObject, StackEndBB);
+  Phi->addIncoming(HeapObject, HeapEndBB);
+
+  StackBuffer = Buffer.getAddress();
+  StackAllocSize = BufferSize.getValue();
+  return Phi;
+}
+
 llvm::Value *irgen::appendSizeForTailAllocatedArrays(IRGenFunction &IGF,
                                                      llvm::Value *size,
                                                      TailArraysRef TailArrays) {
@@ -665,7 +756,8 @@ llvm::Value *irgen::appendSizeForTailAllocatedArrays(IRGenFunction &IGF,
 /// Emit an allocation of a class.
 llvm::Value *irgen::emitClassAllocation(IRGenFunction &IGF, SILType selfType,
                                         bool objc, int &StackAllocSize,
-                                        TailArraysRef TailArrays) {
+                                        TailArraysRef TailArrays,
+                                        llvm::Value **ConditionalStackBuffer) {
   auto &classTI = IGF.getTypeInfo(selfType).as<ClassTypeInfo>();
   auto classType = selfType.getSwiftRValueType();
 
@@ -697,6 +789,11 @@ llvm::Value *irgen::emitClassAllocation(IRGenFunction &IGF, SILType selfType,
                                            TailArrays)) {
     val = IGF.Builder.CreateBitCast(Promoted, IGF.IGM.RefCountedPtrTy);
     val = IGF.emitInitStackObjectCall(metadata, val, "reference.new");
+  } else if (ConditionalStackBuffer &&
+             (val = emitConditionalStackAllocation(
+                  IGF, layout, metadata, size, alignMask, StackAllocSize,
+                  TailArrays, *ConditionalStackBuffer))) {
+    // The object is allocated on the stack if it fits into the buffer.
   } else {
     // Allocate the object on the heap.
     size = appendSizeForTailAllocatedArrays(IGF, size, TailArrays);
@@ -97,8 +97,13 @@ namespace irgen {
   /// means that no stack allocation is possible.
   /// The returned \p StackAllocSize value is the actual size if the object is
   /// allocated on the stack or -1, if the object is allocated on the heap.
+  /// If \p ConditionalStackBuffer is not null, an object with a tail-allocated
+  /// array of a runtime count may be allocated in a stack buffer if the count
+  /// is small enough. In this case the buffer is returned in
+  /// \p ConditionalStackBuffer and \p StackAllocSize is the buffer's size.
   llvm::Value *emitClassAllocation(IRGenFunction &IGF, SILType selfType,
-                  bool objc, int &StackAllocSize, TailArraysRef TailArrays);
+                  bool objc, int &StackAllocSize, TailArraysRef TailArrays,
+                  llvm::Value **ConditionalStackBuffer = nullptr);
 
   /// Emit an allocation of a class using a metadata value.
   llvm::Value *emitClassAllocationDynamic(IRGenFunction &IGF, 
@@ -1297,6 +1297,9 @@ emitInPlaceTypeMetadataAccessFunctionBody(IRGenFunction &IGF,
   return relocatedMetadata;
 }
 
+static llvm::Value *emitPrespecializedGenericMetadataRef(IRGenFunction &IGF,
+                                                         CanType type);
+
 /// Emit the body of a metadata accessor function for the given type.
 ///
 /// This function is appropriate for ordinary situations where the
@@ -1316,6 +1319,11 @@ static llvm::Value *emitTypeMetadataAccessFunctionBody(IRGenFunction &IGF,
 
   if (typeDecl->isGenericContext() &&
       !(isa<ClassDecl>(typeDecl) && typeDecl->hasClangNode())) {
+    // If the instantiation could be laid out statically, hand the runtime
+    // our copy instead of having it instantiate the pattern.
+    if (auto metadata = emitPrespecializedGenericMetadataRef(IGF, type))
+      return metadata;
+
     // This is a metadata accessor for a fully substituted generic type.
     return emitDirectTypeMetadataRef(IGF, type);
   }
@@ -4957,6 +4965,197 @@ namespace {
                             IGF.IGM.getLoweredType(structTy));
     }
   };
+
+  /// A builder for the metadata of an instantiation of a generic struct whose
+  /// layout doesn't depend on its generic arguments.
+  ///
+  /// The result has the same layout as the metadata instantiated from the
+  /// pattern, except that the nominal type descriptor is left null: it may
+  /// be defined in another image, and the runtime copies it from the pattern
+  /// when the metadata is registered.
+  class PrespecializedStructMetadataBuilder :
+    public StructMetadataBuilderBase<PrespecializedStructMetadataBuilder> {
+
+    typedef StructMetadataBuilderBase super;
+
+    /// The metadata of the generic arguments, in layout order.
+    ArrayRef<llvm::Constant *> GenericArgs;
+    unsigned NextGenericArg = 0;
+
+    /// The offset of the generic arguments from the start of the metadata.
+    Size GenericArgsOffset = Size::invalid();
+
+  public:
+    PrespecializedStructMetadataBuilder(IRGenModule &IGM, StructDecl *theStruct,
+                                        ArrayRef<llvm::Constant *> genericArgs,
+                                     llvm::GlobalVariable *relativeAddressBase)
+      : super(IGM, theStruct, relativeAddressBase), GenericArgs(genericArgs) {}
+
+    Size getGenericArgsOffset() const { return GenericArgsOffset; }
+
+    void layout() {
+      super::layout();
+      assert(NextGenericArg == GenericArgs.size() &&
+             "not all generic arguments were used");
+
+      // Save a slot for the field type vector, like the pattern does.
+      addWord(
+         llvm::ConstantPointerNull::get(IGM.TypeMetadataPtrTy->getPointerTo()));
+    }
+
+    void addValueWitnessTable() {
+      auto type = Target->getDeclaredTypeOfContext()->getCanonicalType();
+      addWord(llvm::ConstantExpr::getBitCast(
+                 IGM.getAddrOfValueWitnessTable(type), IGM.WitnessTablePtrTy));
+    }
+
+    void addNominalTypeDescriptor() {
+      addConstantWord(0);
+    }
+
+    void flagUnfilledParent() {
+      llvm_unreachable("prespecialized struct has a parent type");
+    }
+
+    void flagUnfilledFieldOffset() {
+      llvm_unreachable("prespecialized struct has a dependent layout");
+    }
+
+    void noteStartOfGenericRequirements() {
+      GenericArgsOffset = getNextOffset();
+    }
+
+    void addGenericArgument(CanType type) {
+      addWord(GenericArgs[NextGenericArg++]);
+    }
+
+    void addGenericWitnessTable(CanType type, ProtocolConformanceRef conf) {
+      llvm_unreachable("prespecialized struct has conformance requirements");
+    }
+  };
+}
+
+/// Returns true if the metadata of the given instantiation of a generic
+/// struct can be emitted statically, and collects the metadata of its
+/// generic arguments in layout order.
+static bool
+canPrespecializeStructMetadata(IRGenModule &IGM, CanType type,
+                               StructDecl *structDecl,
+                               SmallVectorImpl<llvm::Constant *> &args) {
+  // We don't know the layout of imported and resilient structs, and
+  // structs nested in other types would need their parent's metadata.
+  if (structDecl->hasClangNode() ||
+      IGM.isResilient(structDecl, ResilienceExpansion::Maximal) ||
+      structDecl->getDeclContext()->isTypeContext())
+    return false;
+
+  // The value witness table and the field offsets of the instantiation must
+  // be the ones of the pattern.
+  CanType unboundType =
+    structDecl->getDeclaredTypeOfContext()->getCanonicalType();
+  if (hasDependentValueWitnessTable(IGM, unboundType))
+    return false;
+
+  GenericTypeRequirements requirements(IGM, structDecl);
+  if (requirements.hasParentType())
+    return false;
+
+  bool canPrespecialize = true;
+  auto subs = type->gatherAllSubstitutions(IGM.getSwiftModule(), nullptr);
+  requirements.enumerateFulfillments(IGM, subs,
+                                [&](unsigned reqtIndex, CanType argType,
+                                    Optional<ProtocolConformanceRef> conf) {
+    if (!canPrespecialize)
+      return;
+
+    // TODO: Witness tables of conformances which don't depend on the
+    // generic arguments are constant, too.
+    if (conf) {
+      canPrespecialize = false;
+      return;
+    }
+
+    auto argMetadata =
+      tryEmitConstantTypeMetadataRef(IGM, argType,
+                                     SymbolReferenceKind::Absolute)
+        .getDirectValue();
+    if (!argMetadata) {
+      canPrespecialize = false;
+      return;
+    }
+    args.push_back(argMetadata);
+  });
+
+  return canPrespecialize;
+}
+
+/// If the metadata of the given instantiation of a generic type can be
+/// emitted statically, emit it and return a call which registers it with the
+/// runtime's metadata cache. The runtime returns metadata for the same
+/// arguments which was instantiated or registered earlier, so the result is
+/// still unique.
+///
+/// Returns null if the metadata has to be instantiated at runtime.
+static llvm::Value *emitPrespecializedGenericMetadataRef(IRGenFunction &IGF,
+                                                         CanType type) {
+  IRGenModule &IGM = IGF.IGM;
+  if (!IGM.IRGen.Opts.Optimize ||
+      !IGM.IRGen.Opts.EnableGenericMetadataPrespecialization)
+    return nullptr;
+
+  // TODO: enums.
+  auto structType = dyn_cast<BoundGenericStructType>(type);
+  if (!structType)
+    return nullptr;
+  StructDecl *structDecl = structType->getDecl();
+
+  SmallVector<llvm::Constant *, 4> genericArgs;
+  if (!canPrespecializeStructMetadata(IGM, type, structDecl, genericArgs))
+    return nullptr;
+
+  auto tempBase = createTemporaryRelativeAddressBase(IGM);
+  PrespecializedStructMetadataBuilder builder(IGM, structDecl, genericArgs,
+                                              tempBase.get());
+  builder.layout();
+  llvm::Constant *init = builder.getInit();
+
+  // The runtime fills in the nominal type descriptor and the field type
+  // vector, so the metadata can't be constant.
+  llvm::SmallString<64> name;
+  LinkEntity::forTypeMetadata(type, TypeMetadataAddress::FullMetadata,
+                              /*isPattern*/ false).mangle(name);
+  auto var = new llvm::GlobalVariable(IGM.Module, init->getType(),
+                                      /*constant*/ false,
+                                      llvm::GlobalValue::PrivateLinkage,
+                                      init, name);
+  var->setAlignment(IGM.getPointerAlignment().getValue());
+  replaceTemporaryRelativeAddressBase(IGM, std::move(tempBase), var);
+
+  auto getAddressAtOffset = [&](Size offset) -> llvm::Constant * {
+    auto bytes = llvm::ConstantExpr::getBitCast(var, IGM.Int8PtrTy);
+    return llvm::ConstantExpr::getInBoundsGetElementPtr(IGM.Int8Ty, bytes,
+                    llvm::ConstantInt::get(IGM.SizeTy, offset.getValue()));
+  };
+
+  // The address point follows the value witness table.
+  llvm::Constant *candidate = llvm::ConstantExpr::getBitCast(
+      getAddressAtOffset(IGM.getPointerSize() *
+                         MetadataAdjustmentIndex::ValueType),
+      IGM.TypeMetadataPtrTy);
+
+  // The generic arguments in the metadata double as the key of the cache.
+  llvm::Constant *arguments =
+    getAddressAtOffset(builder.getGenericArgsOffset());
+
+  llvm::Constant *pattern =
+    IGM.getAddrOfTypeMetadata(
+        structDecl->getDeclaredType()->getCanonicalType(), /*pattern*/ true);
+
+  auto call =
+    IGF.Builder.CreateCall(IGM.getGetPrespecializedGenericMetadataFn(),
+                           {pattern, arguments, candidate});
+  call->setDoesNotThrow();
+  return call;
 }
 
 /// Emit the type metadata or metadata template for a struct.
@@ -49,6 +49,8 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Mutex.h"
 #include "llvm/Support/MD5.h"
+#include "llvm/Support/Process.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Target/TargetMachine.h"
@@ -66,6 +68,13 @@ using namespace swift;
 using namespace irgen;
 using namespace llvm;
 
+STATISTIC(NumObjectCacheHits,
+          "Number of object files copied from the LLVM object cache");
+STATISTIC(NumObjectCacheMisses,
+          "Number of object files not found in the LLVM object cache");
+STATISTIC(NumObjectCacheEvictions,
+          "Number of object files evicted from the LLVM object cache");
+
 namespace {
 // We need this to access IRGenOptions from extension functions
 class PassManagerBuilderWrapper : public PassManagerBuilder {
@@ -290,6 +299,14 @@ static void getHashOfModule(MD5::MD5Result &Result, IRGenOptions &Opts,
   // reflected in the llvm module itself.
   HashStream << Opts.getLLVMCodeGenOptionsHash();
 
+  // The object files in the object cache may be shared between compilations
+  // for different targets.
+  if (TargetMachine) {
+    HashStream << TargetMachine->getTargetTriple().str() << ','
+               << TargetMachine->getTargetCPU() << ','
+               << TargetMachine->getTargetFeatureString();
+  }
+
   HashStream.final(Result);
 }
 
@@ -343,6 +360,100 @@ static bool needsRecompile(StringRef OutputFilename, ArrayRef<uint8_t> HashData,
   return true;
 }
 
+/// Returns the path of the object file for the IR hash \p HashStr in the
+/// object cache.
+static std::string getObjectCacheEntryPath(StringRef CachePath,
+                                           StringRef HashStr) {
+  SmallString<128> Path(CachePath);
+  llvm::sys::path::append(Path, HashStr + ".o");
+  return Path.str().str();
+}
+
+/// Copies the object file for \p HashStr from the object cache to
+/// \p OutputFilename. Returns false if the cache has no such object file.
+static bool restoreFromObjectCache(StringRef CachePath, StringRef HashStr,
+                                   StringRef OutputFilename) {
+  std::string EntryPath = getObjectCacheEntryPath(CachePath, HashStr);
+  if (!llvm::sys::fs::exists(EntryPath))
+    return false;
+  if (llvm::sys::fs::copy_file(EntryPath, OutputFilename))
+    return false;
+
+  // Mark the entry as recently used, so that it is evicted last.
+  int FD;
+  if (!llvm::sys::fs::openFileForWrite(EntryPath, FD,
+                                       llvm::sys::fs::F_Append)) {
+    (void)llvm::sys::fs::setLastModificationAndAccessTime(
+        FD, llvm::sys::TimeValue::now());
+    llvm::sys::Process::SafelyCloseFileDescriptor(FD);
+  }
+  return true;
+}
+
+/// Removes the least recently used object files from the object cache until
+/// its size is below \p SizeLimit.
+static void pruneObjectCache(StringRef CachePath, uint64_t SizeLimit) {
+  struct Entry {
+    std::string Path;
+    uint64_t Size;
+    llvm::sys::TimeValue LastUsed;
+  };
+  std::vector<Entry> Entries;
+  uint64_t TotalSize = 0;
+
+  std::error_code EC;
+  for (llvm::sys::fs::directory_iterator I(CachePath, EC), E; I != E && !EC;
+       I.increment(EC)) {
+    if (llvm::sys::path::extension(I->path()) != ".o")
+      continue;
+    llvm::sys::fs::file_status Status;
+    if (I->status(Status))
+      continue;
+    Entries.push_back({I->path(), Status.getSize(),
+                       Status.getLastModificationTime()});
+    TotalSize += Status.getSize();
+  }
+  if (TotalSize <= SizeLimit)
+    return;
+
+  std::sort(Entries.begin(), Entries.end(),
+            [](const Entry &LHS, const Entry &RHS) {
+              return LHS.LastUsed < RHS.LastUsed;
+            });
+  for (const Entry &E : Entries) {
+    if (TotalSize <= SizeLimit)
+      break;
+    // Another compilation may have removed the file already.
+    if (!llvm::sys::fs::remove(E.Path))
+      ++NumObjectCacheEvictions;
+    TotalSize -= E.Size;
+  }
+}
+
+/// Adds the object file \p OutputFilename to the object cache. Errors are
+/// ignored, the cache only serves to speed up later compilations.
+static void addToObjectCache(StringRef CachePath, uint64_t SizeLimit,
+                             StringRef HashStr, StringRef OutputFilename) {
+  if (llvm::sys::fs::create_directories(CachePath))
+    return;
+
+  // Copy to a temporary file first and then rename it, so that concurrent
+  // compilations never see a partially written object file.
+  SmallString<128> TmpPath;
+  if (llvm::sys::fs::createUniqueFile(
+          getObjectCacheEntryPath(CachePath, HashStr) + "-%%%%%%%%.tmp",
+          TmpPath))
+    return;
+  if (llvm::sys::fs::copy_file(OutputFilename, TmpPath) ||
+      llvm::sys::fs::rename(TmpPath,
+                            getObjectCacheEntryPath(CachePath, HashStr))) {
+    (void)llvm::sys::fs::remove(TmpPath);
+    return;
+  }
+
+  pruneObjectCache(CachePath, SizeLimit);
+}
+
 /// Run the LLVM passes. In multi-threaded compilation this will be done for
 /// multiple LLVM modules in parallel.
 static bool performLLVM(IRGenOptions &Opts, DiagnosticEngine &Diags,
@@ -352,21 +463,28 @@ static bool performLLVM(IRGenOptions &Opts, DiagnosticEngine &Diags,
                         llvm::TargetMachine *TargetMachine,
                         version::Version const& effectiveLanguageVersion,
                         StringRef OutputFilename) {
-  if (Opts.UseIncrementalLLVMCodeGen && HashGlobal) {
-    // Check if we can skip the llvm part of the compilation if we have an
-    // existing object file which was generated from the same llvm IR.
-    MD5::MD5Result Result;
+  bool UseIncrementalCodeGen = Opts.UseIncrementalLLVMCodeGen && HashGlobal;
+  bool UseObjectCache = !Opts.LLVMObjectCachePath.empty() &&
+                        Opts.OutputKind == IRGenOutputKind::ObjectFile &&
+                        !Opts.PrintInlineTree && !OutputFilename.empty();
+
+  MD5::MD5Result Result;
+  SmallString<32> ResultStr;
+  if (UseIncrementalCodeGen || UseObjectCache) {
     getHashOfModule(Result, Opts, Module, TargetMachine,
                     effectiveLanguageVersion);
+    MD5::stringifyResult(Result, ResultStr);
 
     DEBUG(
       if (DiagMutex) DiagMutex->lock();
-      SmallString<32> ResultStr;
-      MD5::stringifyResult(Result, ResultStr);
       llvm::dbgs() << OutputFilename << ": MD5=" << ResultStr << '\n';
       if (DiagMutex) DiagMutex->unlock();
     );
+  }
 
+  if (UseIncrementalCodeGen) {
+    // Check if we can skip the llvm part of the compilation if we have an
+    // existing object file which was generated from the same llvm IR.
     ArrayRef<uint8_t> HashData(Result, sizeof(MD5::MD5Result));
     if (Opts.OutputKind == IRGenOutputKind::ObjectFile &&
         !Opts.PrintInlineTree &&
@@ -381,6 +499,27 @@ static bool performLLVM(IRGenOptions &Opts, DiagnosticEngine &Diags,
     HashGlobal->setInitializer(HashConstant);
   }
 
+  // Check if an object file for the same llvm IR was generated by a previous
+  // compilation, e.g. of another file or in another build directory.
+  if (UseObjectCache) {
+    if (restoreFromObjectCache(Opts.LLVMObjectCachePath, ResultStr,
+                               OutputFilename)) {
+      ++NumObjectCacheHits;
+      DEBUG(
+        if (DiagMutex) DiagMutex->lock();
+        llvm::dbgs() << OutputFilename << ": object cache hit\n";
+        if (DiagMutex) DiagMutex->unlock();
+      );
+      return false;
+    }
+    ++NumObjectCacheMisses;
+    DEBUG(
+      if (DiagMutex) DiagMutex->lock();
+      llvm::dbgs() << OutputFilename << ": object cache miss\n";
+      if (DiagMutex) DiagMutex->unlock();
+    );
+  }
+
   Optional<raw_fd_ostream> RawOS;
   if (!OutputFilename.empty()) {
     // Try to open the output file.  Clobbering an existing file is fine.
@@ -451,6 +590,13 @@ static bool performLLVM(IRGenOptions &Opts, DiagnosticEngine &Diags,
     SharedTimer timer("LLVM output");
     EmitPasses.run(*Module);
   }
+
+  if (UseObjectCache) {
+    RawOS->close();
+    if (!RawOS->has_error())
+      addToObjectCache(Opts.LLVMObjectCachePath, Opts.LLVMObjectCacheSizeLimit,
+                       ResultStr, OutputFilename);
+  }
   return false;
 }
 
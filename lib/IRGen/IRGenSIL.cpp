@@ -22,6 +22,7 @@
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/InlineAsm.h"
 #include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallBitVector.h"
 #include "llvm/ADT/TinyPtrVector.h"
@@ -314,6 +315,12 @@ public:
   /// All alloc_ref instructions which allocate the object on the stack.
   llvm::SmallPtrSet<SILInstruction *, 8> StackAllocs;
 
+  /// The alloc_ref instructions which allocate the object in a stack buffer
+  /// only if the tail-allocated array is small enough at runtime, mapped to
+  /// the buffer.
+  llvm::SmallDenseMap<SILInstruction *, llvm::Value *, 4>
+      ConditionalStackAllocs;
+
   /// With closure captures it is actually possible to have two function
   /// arguments that both have the same name. Until this is fixed, we need to
   /// also hash the ArgNo here.
@@ -2882,6 +2889,19 @@ void IRGenSILFunction::visitBranchInst(swift::BranchInst *i) {
   Builder.CreateBr(lbb.bb);
 }
 
+/// Scale a pair of 64-bit profile counts down to LLVM branch weights, which
+/// are 32 bits wide.
+static llvm::MDNode *getBranchWeights(llvm::LLVMContext &Ctx,
+                                      std::pair<uint64_t, uint64_t> Counts) {
+  uint64_t Max = std::max(Counts.first, Counts.second);
+  if (Max == 0)
+    return nullptr;
+  uint64_t Scale = Max / UINT32_MAX + 1;
+  // Add one so that a never taken edge is unlikely but not impossible.
+  return llvm::MDBuilder(Ctx).createBranchWeights(
+      uint32_t(Counts.first / Scale + 1), uint32_t(Counts.second / Scale + 1));
+}
+
 void IRGenSILFunction::visitCondBranchInst(swift::CondBranchInst *i) {
   LoweredBB &trueBB = getLoweredBB(i->getTrueBB());
   LoweredBB &falseBB = getLoweredBB(i->getFalseBB());
@@ -2891,7 +2911,11 @@ void IRGenSILFunction::visitCondBranchInst(swift::CondBranchInst *i) {
   addIncomingSILArgumentsToPHINodes(*this, trueBB, i->getTrueArgs());
   addIncomingSILArgumentsToPHINodes(*this, falseBB, i->getFalseArgs());
 
-  Builder.CreateCondBr(condValue, trueBB.bb, falseBB.bb);
+  llvm::MDNode *weights = nullptr;
+  if (auto counts = i->getEdgeCounts())
+    weights = getBranchWeights(IGM.getLLVMContext(), *counts);
+
+  Builder.CreateCondBr(condValue, trueBB.bb, falseBB.bb, weights);
 }
 
 void IRGenSILFunction::visitRetainValueInst(swift::RetainValueInst *i) {
@@ -3541,12 +3565,16 @@ void IRGenSILFunction::visitAllocRefInst(swift::AllocRefInst *i) {
   SmallVector<std::pair<SILType, llvm::Value *>, 4> TailArrays;
   buildTailArrays(*this, TailArrays, i);
 
+  llvm::Value *StackBuffer = nullptr;
   llvm::Value *alloced = emitClassAllocation(*this, i->getType(), i->isObjC(),
-                                             StackAllocSize, TailArrays);
+                                             StackAllocSize, TailArrays,
+                                             &StackBuffer);
   if (StackAllocSize >= 0) {
     // Remember that this alloc_ref allocates the object on the stack.
-
-    StackAllocs.insert(i);
+    if (StackBuffer)
+      ConditionalStackAllocs[i] = StackBuffer;
+    else
+      StackAllocs.insert(i);
     EstimatedStackSize += StackAllocSize;
   }
   Explosion e;
@@ -3600,6 +3628,9 @@ void IRGenSILFunction::visitDeallocRefInst(swift::DeallocRefInst *i) {
       return;
     }
 
+    // This includes objects which are only allocated on the stack if they fit
+    // into their buffer. The runtime doesn't free objects which were
+    // initialized with swift_initStackObject.
     auto classType = i->getOperand()->getType();
     emitClassDeallocation(*this, classType, selfValue);
     return;
@@ -3608,6 +3639,13 @@ void IRGenSILFunction::visitDeallocRefInst(swift::DeallocRefInst *i) {
   // object on the stack, we don't have to deallocate it, because it is
   // deallocated in the final release.
   assert(ARI->canAllocOnStack());
+  auto ConditionalIter = ConditionalStackAllocs.find(ARI);
+  if (ConditionalIter != ConditionalStackAllocs.end()) {
+    // The object may be on the heap and already be freed, so we must not
+    // touch it. Just end the lifetime of the buffer.
+    Builder.CreateLifetimeEnd(ConditionalIter->second);
+    return;
+  }
   if (StackAllocs.count(ARI)) {
     if (IGM.IRGen.Opts.EmitStackPromotionChecks) {
       selfValue = Builder.CreateBitCast(selfValue, IGM.RefCountedPtrTy);
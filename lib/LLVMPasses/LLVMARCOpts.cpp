@@ -39,6 +39,7 @@
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/TinyPtrVector.h"
 #include "llvm/ADT/Triple.h"
+#include "llvm/IR/CFG.h"
 #include "llvm/IR/InstIterator.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/Support/raw_ostream.h"
@@ -54,6 +55,8 @@ STATISTIC(NumRetainReleasePairs,
           "Number of swift retain/release pairs eliminated");
 STATISTIC(NumObjCRetainReleasePairs,
           "Number of objc retain/release pairs eliminated");
+STATISTIC(NumCrossBlockRetainReleasePairs,
+          "Number of swift retain/release pairs in different blocks eliminated");
 STATISTIC(NumAllocateReleasePairs,
           "Number of swift allocate/release pairs eliminated");
 STATISTIC(NumStoreOnlyObjectsEliminated,
@@ -518,6 +521,212 @@ OutOfLoop:
 }
 
 
+//===----------------------------------------------------------------------===//
+//                    Cross-Block Retain/Release Pairing
+//===----------------------------------------------------------------------===//
+
+/// The maximum number of blocks which are scanned to find the retains that
+/// are paired with a release.
+static constexpr unsigned MaxPairingBlocks = 16;
+
+/// Returns the retain kind which is paired with the release kind \p Kind.
+static RT_Kind getMatchingRetainKind(RT_Kind Kind) {
+  switch (Kind) {
+  case RT_Release: return RT_Retain;
+  case RT_UnknownRelease: return RT_UnknownRetain;
+  case RT_ObjCRelease: return RT_ObjCRetain;
+  case RT_BridgeRelease: return RT_BridgeRetain;
+  default: llvm_unreachable("not a release");
+  }
+}
+
+namespace {
+/// Finds the retains which are paired with a release across basic blocks.
+///
+/// Starting at the release, the scan walks backwards over instructions which
+/// cannot decrement the reference count of the object, and continues in all
+/// predecessors when it reaches the top of a block. It succeeds if every
+/// backward path ends in a retain of the object and every path from one of
+/// these retains reaches the release without leaving the scanned blocks. Then
+/// the retains and the release cancel out on every path.
+class RetainReleasePairing {
+  CallInst &Release;
+  RT_Kind RetainKind;
+  Value *Object;
+  Value *Root;
+  SwiftRCIdentity *RC;
+
+  /// Blocks which were scanned from the terminator to the top.
+  SmallPtrSet<BasicBlock *, 8> TransparentBlocks;
+  /// Blocks which were scanned from the terminator to a paired retain.
+  SmallPtrSet<BasicBlock *, 8> RetainBlocks;
+  SmallVector<CallInst *, 4> Retains;
+  SmallVector<BasicBlock *, 8> Worklist;
+
+  enum class ScanResult { FoundRetain, ReachedTop, Blocked };
+
+  /// Scans backwards from \p I (exclusive) to the top of its block.
+  ScanResult scanBlock(BasicBlock::iterator I, BasicBlock &BB);
+
+public:
+  RetainReleasePairing(CallInst &Release, SwiftRCIdentity *RC)
+      : Release(Release),
+        RetainKind(getMatchingRetainKind(classifyInstruction(Release))),
+        Object(Release.getArgOperand(0)),
+        Root(RC->getSwiftRCIdentityRoot(Object)), RC(RC) {}
+
+  /// Computes the paired retains. Returns false if the release can't be
+  /// paired.
+  bool compute();
+
+  ArrayRef<CallInst *> getRetains() const { return Retains; }
+};
+} // end anonymous namespace
+
+RetainReleasePairing::ScanResult
+RetainReleasePairing::scanBlock(BasicBlock::iterator I, BasicBlock &BB) {
+  while (I != BB.begin()) {
+    --I;
+    Instruction &Inst = *I;
+
+    // Don't move the object's lifetime above its definition.
+    if (&Inst == Object || &Inst == Root)
+      return ScanResult::Blocked;
+    if (isa<PHINode>(Inst))
+      return ScanResult::ReachedTop;
+
+    RT_Kind Kind = classifyInstruction(Inst);
+    switch (Kind) {
+    case RT_NoMemoryAccessed:
+      continue;
+
+    case RT_UnknownRelease:
+    case RT_BridgeRelease:
+    case RT_ObjCRelease:
+    case RT_Release:
+      // As in the local release motion, releases of other objects are
+      // ignored.
+      if (RC->getSwiftRCIdentityRoot(cast<CallInst>(Inst).getArgOperand(0)) ==
+          Root)
+        return ScanResult::Blocked;
+      continue;
+
+    case RT_UnknownRetain:
+    case RT_BridgeRetain:
+    case RT_ObjCRetain:
+    case RT_Retain:
+      if (Kind == RetainKind &&
+          RC->getSwiftRCIdentityRoot(cast<CallInst>(Inst).getArgOperand(0)) ==
+              Root) {
+        Retains.push_back(cast<CallInst>(&Inst));
+        return ScanResult::FoundRetain;
+      }
+      return ScanResult::Blocked;
+
+    default:
+      return ScanResult::Blocked;
+    }
+  }
+  return ScanResult::ReachedTop;
+}
+
+bool RetainReleasePairing::compute() {
+  BasicBlock *ReleaseBB = Release.getParent();
+
+  // A retain in the same block is handled by the local release motion.
+  if (scanBlock(Release.getIterator(), *ReleaseBB) != ScanResult::ReachedTop)
+    return false;
+  if (isa<PHINode>(Object) || isa<PHINode>(Root))
+    return false;
+
+  auto addPredecessors = [&](BasicBlock *BB) -> bool {
+    if (pred_empty(BB))
+      return false;
+    for (BasicBlock *Pred : predecessors(BB)) {
+      // Scanning the release block from its end would reach the release.
+      if (Pred == ReleaseBB)
+        return false;
+      if (TransparentBlocks.count(Pred) || RetainBlocks.count(Pred) ||
+          std::find(Worklist.begin(), Worklist.end(), Pred) != Worklist.end())
+        continue;
+      Worklist.push_back(Pred);
+    }
+    return true;
+  };
+
+  if (!addPredecessors(ReleaseBB))
+    return false;
+
+  while (!Worklist.empty()) {
+    BasicBlock *BB = Worklist.pop_back_val();
+    if (TransparentBlocks.size() + RetainBlocks.size() >= MaxPairingBlocks)
+      return false;
+
+    // Only branches can terminate the scanned blocks.
+    TerminatorInst *TI = BB->getTerminator();
+    if (!isa<BranchInst>(TI) && !isa<SwitchInst>(TI))
+      return false;
+
+    switch (scanBlock(BB->getTerminator()->getIterator(), *BB)) {
+    case ScanResult::Blocked:
+      return false;
+    case ScanResult::FoundRetain:
+      RetainBlocks.insert(BB);
+      break;
+    case ScanResult::ReachedTop:
+      TransparentBlocks.insert(BB);
+      if (!addPredecessors(BB))
+        return false;
+      break;
+    }
+  }
+
+  // All paths from the retains must reach the release.
+  auto isInRegion = [&](BasicBlock *BB) {
+    return BB == ReleaseBB || TransparentBlocks.count(BB);
+  };
+  for (auto *Blocks : {&TransparentBlocks, &RetainBlocks})
+    for (BasicBlock *BB : *Blocks)
+      for (BasicBlock *Succ : successors(BB))
+        if (!isInRegion(Succ))
+          return false;
+
+  return !Retains.empty();
+}
+
+/// performGlobalRetainReleasePairing - Remove releases together with the
+/// retains in other blocks which they are paired with on every path, e.g. a
+/// retain before a diamond and a release after it.
+static bool performGlobalRetainReleasePairing(Function &F,
+                                              SwiftRCIdentity *RC) {
+  SmallVector<CallInst *, 16> Releases;
+  for (Instruction &I : instructions(F)) {
+    switch (classifyInstruction(I)) {
+    case RT_UnknownRelease:
+    case RT_BridgeRelease:
+    case RT_ObjCRelease:
+    case RT_Release:
+      Releases.push_back(cast<CallInst>(&I));
+      break;
+    default:
+      break;
+    }
+  }
+
+  bool Changed = false;
+  for (CallInst *Release : Releases) {
+    RetainReleasePairing Pairing(*Release, RC);
+    if (!Pairing.compute())
+      continue;
+    for (CallInst *Retain : Pairing.getRetains())
+      Retain->eraseFromParent();
+    Release->eraseFromParent();
+    ++NumCrossBlockRetainReleasePairs;
+    Changed = true;
+  }
+  return Changed;
+}
+
 //===----------------------------------------------------------------------===//
 //                       Store-Only Object Elimination
 //===----------------------------------------------------------------------===//
@@ -1024,5 +1233,9 @@ bool SwiftARCOpt::runOnFunction(Function &F) {
   //    escape.
   Changed |= performGeneralOptimizations(F, B, RC);
 
+  // Finally, pair the remaining releases with retains in other blocks, e.g.
+  // across diamonds which don't touch the object.
+  Changed |= performGlobalRetainReleasePairing(F, RC);
+
   return Changed;
 }
@@ -27,6 +27,7 @@
 #include "llvm/ADT/Twine.h"
 // FIXME: Figure out if this can be migrated to LLVM.
 #include "clang/Basic/CharInfo.h"
+#include <cstring>
 
 using namespace swift;
 
@@ -306,7 +307,53 @@ static void diagnoseEmbeddedNul(DiagnosticEngine *Diags, const char *Ptr) {
       .fixItRemoveChars(NulLoc, NulEndLoc);
 }
 
+static const uint64_t WordOfOnes = 0x0101010101010101ULL;
+static const uint64_t WordOfHighBits = 0x8080808080808080ULL;
+
+/// Returns true if any of the eight bytes in \p Word is equal to \p C.
+static inline bool wordContainsByte(uint64_t Word, unsigned char C) {
+  uint64_t X = Word ^ (WordOfOnes * C);
+  return ((X - WordOfOnes) & ~X & WordOfHighBits) != 0;
+}
+
+/// Advance over a run of plain ASCII bytes eight bytes at a time, stopping at
+/// the first word that contains a non-ASCII byte or for which
+/// \p ContainsSpecialByte returns true.
+///
+/// The bytes of that last word still have to be processed one by one.
+template <typename PredicateTy>
+static const char *skipASCIIWords(const char *Ptr, const char *End,
+                                  PredicateTy ContainsSpecialByte) {
+  while (End - Ptr >= 8) {
+    uint64_t Word;
+    memcpy(&Word, Ptr, sizeof(Word));
+    if ((Word & WordOfHighBits) != 0 || ContainsSpecialByte(Word))
+      break;
+    Ptr += 8;
+  }
+  return Ptr;
+}
+
+/// Skip bytes that can't end a line comment.
+static const char *skipASCIIWordsInLine(const char *Ptr, const char *End) {
+  return skipASCIIWords(Ptr, End, [](uint64_t Word) {
+    return wordContainsByte(Word, '\n') || wordContainsByte(Word, '\r') ||
+           wordContainsByte(Word, 0);
+  });
+}
+
+/// Skip bytes that can't end, nest or break a block comment.
+static const char *skipASCIIWordsInBlockComment(const char *Ptr,
+                                                const char *End) {
+  return skipASCIIWords(Ptr, End, [](uint64_t Word) {
+    return wordContainsByte(Word, '*') || wordContainsByte(Word, '/') ||
+           wordContainsByte(Word, '\n') || wordContainsByte(Word, '\r') ||
+           wordContainsByte(Word, 0);
+  });
+}
+
 void Lexer::skipToEndOfLine() {
+  CurPtr = skipASCIIWordsInLine(CurPtr, BufferEnd);
   while (1) {
     switch (*CurPtr++) {
     case '\n':
@@ -320,6 +367,7 @@ void Lexer::skipToEndOfLine() {
         const char *CharStart = CurPtr;
         if (validateUTF8CharacterAndAdvance(CurPtr, BufferEnd) == ~0U)
           diagnose(CharStart, diag::lex_invalid_utf8);
+        CurPtr = skipASCIIWordsInLine(CurPtr, BufferEnd);
       }
       break;   // Otherwise, eat other characters.
     case 0:
@@ -361,6 +409,7 @@ void Lexer::skipSlashStarComment() {
   unsigned Depth = 1;
   
   while (1) {
+    CurPtr = skipASCIIWordsInBlockComment(CurPtr, BufferEnd);
     switch (*CurPtr++) {
     case '*':
       // Check for a '*/'
@@ -569,7 +618,12 @@ void Lexer::lexIdentifier() {
   (void) didStart;
 
   // Lex [a-zA-Z_$0-9[[:XID_Continue:]]]*
-  while (advanceIfValidContinuationOfIdentifier(CurPtr, BufferEnd));
+  // Runs of ASCII characters are checked with a table lookup; only the
+  // remaining characters need to be decoded as UTF-8.
+  do {
+    while (clang::isIdentifierBody(*CurPtr, /*dollar*/true))
+      ++CurPtr;
+  } while (advanceIfValidContinuationOfIdentifier(CurPtr, BufferEnd));
 
   tok Kind = kindOfIdentifier(StringRef(TokStart, CurPtr-TokStart), InSILMode);
   return formToken(Kind, TokStart);
@@ -1251,6 +1305,13 @@ void Lexer::lexStringLiteral() {
   bool wasErroneous = false;
   
   while (true) {
+    // Plain printable ASCII characters can neither end the literal nor start
+    // an escape or interpolation; skip them without going through
+    // lexCharacter.
+    while (isPrintable(*CurPtr) && *CurPtr != '"' && *CurPtr != '\'' &&
+           *CurPtr != '\\')
+      ++CurPtr;
+
     if (*CurPtr == '\\' && *(CurPtr + 1) == '(') {
       // Consume tokens until we hit the corresponding ')'.
       CurPtr += 2;
@@ -1668,6 +1729,9 @@ Restart:
   case '\t':
   case '\f':
   case '\v':
+    // Skip the rest of a run of blanks, such as indentation, in one go.
+    while (*CurPtr == ' ' || *CurPtr == '\t')
+      ++CurPtr;
     goto Restart;  // Skip whitespace.
 
   case -1:
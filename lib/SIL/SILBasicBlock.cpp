@@ -36,6 +36,11 @@ SILBasicBlock::SILBasicBlock(SILFunction *parent, SILBasicBlock *afterBB)
     parent->getBlocks().push_back(this);
   }
 }
+void *SILBasicBlock::operator new(size_t Bytes, SILModule &M) {
+  assert(Bytes == sizeof(SILBasicBlock) && "unexpected block size");
+  return M.allocateBlock();
+}
+
 SILBasicBlock::~SILBasicBlock() {
   // Invalidate all of the basic block arguments.
   for (auto *Arg : ArgumentList) {
@@ -167,6 +172,12 @@ void SILBasicBlock::moveAfter(SILBasicBlock *After) {
   BlkList.splice(InsertPt, BlkList, this);
 }
 
+void llvm::ilist_traits<swift::SILBasicBlock>::deleteNode(SILBasicBlock *BB) {
+  SILModule &M = BB->getModule();
+  BB->~SILBasicBlock();
+  M.deallocateBlock(BB);
+}
+
 void
 llvm::ilist_traits<swift::SILBasicBlock>::
 transferNodesFromList(llvm::ilist_traits<SILBasicBlock> &SrcTraits,
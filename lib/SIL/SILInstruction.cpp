@@ -162,11 +162,11 @@ void SILInstruction::dropAllReferences() {
 }
 
 void SILInstruction::replaceAllUsesWithUndef() {
-  SILModule &Mod = getModule();
-  while (!use_empty()) {
-    Operand *Op = *use_begin();
-    Op->set(SILUndef::get(Op->get()->getType(), Mod));
-  }
+  if (use_empty())
+    return;
+  // All uses have the same type, so there is no need to look up the undef
+  // value for every use.
+  replaceAllUsesWith(SILUndef::get(getType(), getModule()));
 }
 
 namespace {
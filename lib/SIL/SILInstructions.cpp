@@ -1081,6 +1081,36 @@ MutableArrayRef<Operand> CondBranchInst::getFalseOperands() {
   return MutableArrayRef<Operand>(&Operands[1+NumTrueArgs], NumFalseArgs);
 }
 
+/// Returns the profile count of \p DestBB if all of its executions are
+/// reached through a single edge.
+static Optional<uint64_t> getEdgeCount(const SILBasicBlock *DestBB) {
+  if (!DestBB->getSinglePredecessor())
+    return None;
+  return DestBB->getProfileCount();
+}
+
+Optional<std::pair<uint64_t, uint64_t>> CondBranchInst::getEdgeCounts() const {
+  if (getTrueBB() == getFalseBB())
+    return None;
+
+  Optional<uint64_t> TrueCount = getEdgeCount(getTrueBB());
+  Optional<uint64_t> FalseCount = getEdgeCount(getFalseBB());
+  if (TrueCount && FalseCount)
+    return std::make_pair(*TrueCount, *FalseCount);
+
+  // SILGen only records counts at the start of regions, e.g. the "then" block
+  // of an if-statement. Derive the other edge from the count of the branching
+  // block itself.
+  Optional<uint64_t> ParentCount = getParent()->getProfileCount();
+  if (!ParentCount)
+    return None;
+  if (TrueCount && *TrueCount <= *ParentCount)
+    return std::make_pair(*TrueCount, *ParentCount - *TrueCount);
+  if (FalseCount && *FalseCount <= *ParentCount)
+    return std::make_pair(*ParentCount - *FalseCount, *FalseCount);
+  return None;
+}
+
 void CondBranchInst::swapSuccessors() {
   // Swap our destinations.
   SILBasicBlock *First = DestBBs[0].getBB();
@@ -29,6 +29,11 @@
 using namespace swift;
 using namespace Lowering;
 
+STATISTIC(NumInstsAllocated, "Number of instructions allocated");
+STATISTIC(NumInstsDeallocated, "Number of instructions deallocated");
+STATISTIC(NumBlocksAllocated, "Number of basic blocks allocated");
+STATISTIC(NumBlocksReused, "Number of basic blocks allocated in reused memory");
+
 class SILModule::SerializationCallback : public SerializedSILLoader::Callback {
   void didDeserialize(Module *M, SILFunction *fn) override {
     updateLinkage(fn);
@@ -107,13 +112,48 @@ void *SILModule::allocate(unsigned Size, unsigned Align) const {
 }
 
 void *SILModule::allocateInst(unsigned Size, unsigned Align) const {
+  ++NumInstsAllocated;
   return AlignedAlloc(Size, Align);
 }
 
 void SILModule::deallocateInst(SILInstruction *I) {
+  ++NumInstsDeallocated;
   AlignedFree(I);
 }
 
+void *SILModule::allocateBlock() {
+  ++NumBlocksAllocated;
+  if (getASTContext().LangOpts.UseMalloc)
+    return AlignedAlloc(sizeof(SILBasicBlock), alignof(SILBasicBlock));
+
+  if (void *Block = FreeBlocks) {
+    FreeBlocks = *reinterpret_cast<void **>(Block);
+    ++NumBlocksReused;
+    return Block;
+  }
+  return BPA.Allocate(sizeof(SILBasicBlock), alignof(SILBasicBlock));
+}
+
+void SILModule::deallocateBlock(SILBasicBlock *BB) {
+  if (getASTContext().LangOpts.UseMalloc) {
+    AlignedFree(BB);
+    return;
+  }
+
+  // Blocks are allocated in the bump pointer allocator, so instead of freeing
+  // the memory put it on the free list.
+  static_assert(sizeof(SILBasicBlock) >= sizeof(void *),
+                "a free block must be able to hold the next pointer");
+  void *Block = BB;
+#ifndef NDEBUG
+  // Poison the block, so that a dangling reference to it crashes early
+  // instead of silently using a new block which reuses the memory.
+  memset(Block, 0xdb, sizeof(SILBasicBlock));
+#endif
+  *reinterpret_cast<void **>(Block) = FreeBlocks;
+  FreeBlocks = Block;
+}
+
 SILWitnessTable *
 SILModule::createWitnessTableDeclaration(ProtocolConformance *C,
                                          SILLinkage linkage) {
@@ -537,6 +537,11 @@ public:
       for (auto Id : PredIDs)
         *this << ' ' << Id;
     }
+
+    if (auto Count = BB->getProfileCount()) {
+      PrintState.OS.PadToColumn(50);
+      *this << "// count: " << *Count;
+    }
     *this << '\n';
 
     for (const SILInstruction &I : *BB) {
@@ -23,6 +23,7 @@
 #include "llvm/ProfileData/Coverage/CoverageMapping.h"
 #include "llvm/ProfileData/Coverage/CoverageMappingWriter.h"
 #include "llvm/ProfileData/InstrProf.h"
+#include "llvm/ProfileData/InstrProfReader.h"
 
 #include <forward_list>
 
@@ -83,10 +84,11 @@ ProfilerRAII::ProfilerRAII(SILGenModule &SGM, Decl *D)
   assert(isa<AbstractFunctionDecl>(D) ||
          isa<TopLevelCodeDecl>(D) && "Cannot create profiler for this decl");
   const auto &Opts = SGM.M.getOptions();
-  if (!Opts.GenerateProfile || isUnmappedDecl(D))
+  if ((!Opts.GenerateProfile && !SGM.PGOReader) || isUnmappedDecl(D))
     return;
-  SGM.Profiler =
-      llvm::make_unique<SILGenProfiling>(SGM, Opts.EmitProfileCoverageMapping);
+  SGM.Profiler = llvm::make_unique<SILGenProfiling>(
+      SGM, Opts.GenerateProfile,
+      Opts.GenerateProfile && Opts.EmitProfileCoverageMapping);
   SGM.Profiler->assignRegionCounters(D);
 }
 
@@ -720,6 +722,22 @@ void SILGenProfiling::assignRegionCounters(Decl *Root) {
   // TODO: Mapper needs to calculate a function hash as it goes.
   FunctionHash = 0x0;
 
+  PGOFuncName = llvm::getPGOFuncName(
+      CurrentFuncName, getEquivalentPGOLinkage(CurrentFuncLinkage),
+      CurrentFileName);
+
+  if (SGM.PGOReader) {
+    if (auto E = SGM.PGOReader->getFunctionCounts(PGOFuncName, FunctionHash,
+                                                  ProfileCounts)) {
+      llvm::consumeError(std::move(E));
+      ProfileCounts.clear();
+    }
+    // Without a real function hash, a stale profile can only be detected by
+    // a mismatching number of counters.
+    if (ProfileCounts.size() != NumRegionCounters)
+      ProfileCounts.clear();
+  }
+
   if (EmitCoverageMapping) {
     CoverageMapping Coverage(SM);
     walkForProfiling(Root, Coverage);
@@ -748,13 +766,18 @@ void SILGenProfiling::emitCounterIncrement(SILGenBuilder &Builder,ASTNode Node){
   assert(CounterIt != RegionCounterMap.end() &&
          "cannot increment non-existent counter");
 
+  // Counters are incremented at the start of the region they count, so the
+  // profiled count of the region is the count of the current block.
+  if (!ProfileCounts.empty())
+    Builder.getInsertionBB()->setProfileCount(
+        ProfileCounts[CounterIt->second]);
+
+  if (!EmitInstrumentation)
+    return;
+
   auto Int32Ty = SGM.Types.getLoweredType(BuiltinIntegerType::get(32, C));
   auto Int64Ty = SGM.Types.getLoweredType(BuiltinIntegerType::get(64, C));
 
-  std::string PGOFuncName = llvm::getPGOFuncName(
-      CurrentFuncName, getEquivalentPGOLinkage(CurrentFuncLinkage),
-      CurrentFileName);
-
   SILLocation Loc = getLocation(Node);
   SILValue Args[] = {
       // The intrinsic must refer to the function profiling name var, which is
@@ -33,26 +33,35 @@ struct ProfilerRAII;
 class SILGenProfiling {
 private:
   SILGenModule &SGM;
+  bool EmitInstrumentation;
   bool EmitCoverageMapping;
 
   // The current function's name and counter data.
   std::string CurrentFuncName;
+  std::string PGOFuncName;
   StringRef CurrentFileName;
   FormalLinkage CurrentFuncLinkage;
   unsigned NumRegionCounters;
   uint64_t FunctionHash;
   llvm::DenseMap<ASTNode, unsigned> RegionCounterMap;
 
+  // The current function's counter values read from the profile, or empty if
+  // there is no profile data for it.
+  std::vector<uint64_t> ProfileCounts;
+
   std::vector<std::tuple<std::string, uint64_t, std::string>> CoverageData;
 
 public:
-  SILGenProfiling(SILGenModule &SGM, bool EmitCoverageMapping)
-      : SGM(SGM), EmitCoverageMapping(EmitCoverageMapping),
-        NumRegionCounters(0), FunctionHash(0) {}
+  SILGenProfiling(SILGenModule &SGM, bool EmitInstrumentation,
+                  bool EmitCoverageMapping)
+      : SGM(SGM), EmitInstrumentation(EmitInstrumentation),
+        EmitCoverageMapping(EmitCoverageMapping), NumRegionCounters(0),
+        FunctionHash(0) {}
 
   bool hasRegionCounters() const { return NumRegionCounters != 0; }
 
-  /// Emit SIL to increment the counter for \c Node.
+  /// Emit SIL to increment the counter for \c Node, and attach the profiled
+  /// count of \c Node to the current block if a profile is used.
   void emitCounterIncrement(SILGenBuilder &Builder, ASTNode Node);
 
 private:
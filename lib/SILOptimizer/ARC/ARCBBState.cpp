@@ -29,49 +29,15 @@ using ARCBBState = ARCSequenceDataflowEvaluator::ARCBBState;
 /// Merge in the state of the successor basic block. This is an intersection
 /// operation.
 void ARCBBState::mergeSuccBottomUp(ARCBBState &SuccBBState) {
-  // For each [(SILValue, BottomUpState)] that we are tracking...
-  for (auto &Pair : getBottomupStates()) {
-    if (!Pair.hasValue())
-      continue;
-
-    SILValue RefCountedValue = Pair->first;
-
-    // If our SILValue was blotted, skip it. This will be ignored for the rest
-    // of the ARC optimization.
-    if (!RefCountedValue)
-      continue;
-
-    // Then attempt to lookup the corresponding (SILValue, BottomUpState) from
-    // SuccBB. If we fail to do so, blot this SILValue and continue.
-    //
-    // Since we are already initialized by initSuccBottomUp(), this has the
-    // effect of an intersection.
-    auto Other = SuccBBState.PtrToBottomUpState.find(RefCountedValue);
-    if (Other == SuccBBState.PtrToBottomUpState.end()) {
-      PtrToBottomUpState.blot(RefCountedValue);
-      continue;
-    }
-
-    SILValue OtherRefCountedValue = (*Other)->first;
-
-    // If the other ref count value was blotted, blot our value and continue.
-    // This has the effect of an intersection since we already checked earlier
-    // that RefCountedValue was not blotted.
-    if (!OtherRefCountedValue) {
-      PtrToBottomUpState.blot(RefCountedValue);
-      continue;
-    }
-
-    BottomUpRefCountState &RefCountState = Pair->second;
-    BottomUpRefCountState &OtherRefCountState = (*Other)->second;
-
-    // Ok, now we know that the merged set can safely represent a set of
-    // of instructions which together semantically act as one ref count
-    // increment. Merge the two states together.
-    if (!RefCountState.merge(OtherRefCountState)) {
-      PtrToBottomUpState.blot(RefCountedValue);
-    }
-  }
+  // Roots which are not tracked in SuccBB are dropped. For the others, merge
+  // the two states together. If that fails, the merged set of instructions
+  // cannot act as one ref count increment and we stop tracking the root.
+  PtrToBottomUpState.intersect(
+      SuccBBState.PtrToBottomUpState,
+      [](BottomUpRefCountState &RefCountState,
+         const BottomUpRefCountState &OtherRefCountState) {
+        return RefCountState.merge(OtherRefCountState);
+      });
 }
 
 /// Initialize this BB with the state of the successor basic block. This is
@@ -81,53 +47,20 @@ void ARCBBState::initSuccBottomUp(ARCBBState &SuccBBState) {
   PtrToBottomUpState = SuccBBState.PtrToBottomUpState;
 }
 
-/// Merge in the state of the predecessor basic block.
+/// Merge in the state of the predecessor basic block. This is an intersection
+/// operation.
 void ARCBBState::mergePredTopDown(ARCBBState &PredBBState) {
-  // For each [(SILValue, TopDownState)] that we are tracking...
-  for (auto &Pair : getTopDownStates()) {
-    if (!Pair.hasValue())
-      continue;
-
-    SILValue RefCountedValue = Pair->first;
-
-    // If our SILValue was blotted, skip it. This will be ignored in the rest of
-    // the optimizer.
-    if (!RefCountedValue)
-      continue;
-
-    // Then attempt to lookup the corresponding (SILValue, TopDownState) from
-    // PredBB. If we fail to do so, blot this SILValue and continue.
-    //
-    // Since we are already initialized by initPredTopDown(), this has the
-    // effect of an intersection.
-    auto Other = PredBBState.PtrToTopDownState.find(RefCountedValue);
-    if (Other == PredBBState.PtrToTopDownState.end()) {
-      PtrToTopDownState.blot(RefCountedValue);
-      continue;
-    }
-
-    SILValue OtherRefCountedValue = (*Other)->first;
-
-    // If the other ref count value was blotted, blot our value and continue.
-    // This has the effect of an intersection.
-    if (!OtherRefCountedValue) {
-      PtrToTopDownState.blot(RefCountedValue);
-      continue;
-    }
-
-    // Ok, so now we know that the ref counted value we are tracking was not
-    // blotted on either side. Grab the states.
-    TopDownRefCountState &RefCountState = Pair->second;
-    TopDownRefCountState &OtherRefCountState = (*Other)->second;
-
-    // Attempt to merge Other into this ref count state. If we fail, blot this
-    // ref counted value and continue.
-    if (!RefCountState.merge(OtherRefCountState)) {
-      DEBUG(llvm::dbgs() << "Failed to merge!\n");
-      PtrToTopDownState.blot(RefCountedValue);
-      continue;
-    }
-  }
+  // Roots which are not tracked in PredBB are dropped. For the others, attempt
+  // to merge the two states. If we fail, stop tracking the root.
+  PtrToTopDownState.intersect(
+      PredBBState.PtrToTopDownState,
+      [](TopDownRefCountState &RefCountState,
+         const TopDownRefCountState &OtherRefCountState) {
+        if (RefCountState.merge(OtherRefCountState))
+          return true;
+        DEBUG(llvm::dbgs() << "Failed to merge!\n");
+        return false;
+      });
 }
 
 /// Initialize the state for this BB with the state of its predecessor
@@ -149,7 +82,8 @@ using ARCBBStateInfoHandle = ARCSequenceDataflowEvaluator::ARCBBStateInfoHandle;
 } // end anonymous namespace
 
 ARCBBStateInfo::ARCBBStateInfo(SILFunction *F, PostOrderAnalysis *POA,
-                               ProgramTerminationFunctionInfo *PTFI)
+                               ProgramTerminationFunctionInfo *PTFI,
+                               RCRootIndex &Roots)
     : BBToBBIDMap(), BBIDToBottomUpBBStateMap(POA->get(F)->size()),
       BBIDToTopDownBBStateMap(POA->get(F)->size()), BackedgeMap() {
 
@@ -161,8 +95,8 @@ ARCBBStateInfo::ARCBBStateInfo(SILFunction *F, PostOrderAnalysis *POA,
     BBToBBIDMap[BB] = BBID;
 
     bool IsLeakingBB = PTFI->isProgramTerminatingBlock(BB);
-    BBIDToBottomUpBBStateMap[BBID].init(BB, IsLeakingBB);
-    BBIDToTopDownBBStateMap[BBID].init(BB, IsLeakingBB);
+    BBIDToBottomUpBBStateMap[BBID].init(BB, IsLeakingBB, Roots);
+    BBIDToTopDownBBStateMap[BBID].init(BB, IsLeakingBB, Roots);
 
     for (auto &Succ : BB->getSuccessors())
       if (SILBasicBlock *SuccBB = Succ.getBB())
@@ -14,14 +14,15 @@
 #define SWIFT_SILOPTIMIZER_PASSMANAGER_ARC_ARCBBSTATE_H
 
 #include "GlobalARCSequenceDataflow.h"
+#include "RefCountStateMap.h"
 
 namespace swift {
 
 /// \brief Per-BasicBlock state.
 class ARCSequenceDataflowEvaluator::ARCBBState {
 public:
-  using TopDownMapTy = SmallBlotMapVector<SILValue, TopDownRefCountState, 4>;
-  using BottomUpMapTy = SmallBlotMapVector<SILValue, BottomUpRefCountState, 4>;
+  using TopDownMapTy = RefCountStateMap<TopDownRefCountState>;
+  using BottomUpMapTy = RefCountStateMap<BottomUpRefCountState>;
 
 private:
   /// The basic block that this bbstate corresponds to.
@@ -42,10 +43,12 @@ public:
   ARCBBState() : BB() {}
   ARCBBState(SILBasicBlock *BB) : BB(BB) {}
 
-  void init(SILBasicBlock *NewBB, bool NewIsTrapBB) {
+  void init(SILBasicBlock *NewBB, bool NewIsTrapBB, RCRootIndex &Roots) {
     assert(NewBB && "Cannot set NewBB to a nullptr.");
     BB = NewBB;
     IsTrapBB = NewIsTrapBB;
+    PtrToTopDownState.setRootIndex(Roots);
+    PtrToBottomUpState.setRootIndex(Roots);
   }
 
   /// Is this BB a BB that fits the canonical form of a trap?
@@ -188,7 +191,7 @@ class ARCSequenceDataflowEvaluator::ARCBBStateInfo {
 
 public:
   ARCBBStateInfo(SILFunction *F, PostOrderAnalysis *POTA,
-                 ProgramTerminationFunctionInfo *PTFI);
+                 ProgramTerminationFunctionInfo *PTFI, RCRootIndex &Roots);
 
   llvm::Optional<ARCBBStateInfoHandle> getBottomUpBBHandle(SILBasicBlock *BB);
   llvm::Optional<ARCBBStateInfoHandle> getTopDownBBHandle(SILBasicBlock *BB);
@@ -25,9 +25,13 @@ using namespace swift;
 //                               ARCRegionState
 //===----------------------------------------------------------------------===//
 
-ARCRegionState::ARCRegionState(LoopRegion *R, bool AllowsLeaks)
+ARCRegionState::ARCRegionState(LoopRegion *R, bool AllowsLeaks,
+                               RCRootIndex &Roots)
     : Region(R), PtrToTopDownState(), PtrToBottomUpState(),
-      AllowsLeaks(AllowsLeaks) {}
+      AllowsLeaks(AllowsLeaks) {
+  PtrToTopDownState.setRootIndex(Roots);
+  PtrToBottomUpState.setRootIndex(Roots);
+}
 
 //===---
 // Bottom Up Merge
@@ -47,49 +51,16 @@ void ARCRegionState::initSuccBottomUp(ARCRegionState &SuccRegionState) {
 ///
 /// This is an intersection operation.
 void ARCRegionState::mergeSuccBottomUp(ARCRegionState &SuccRegionState) {
-  // Otherwise for each [(SILValue, BottomUpState)] that we are tracking...
-  for (auto &Pair : getBottomupStates()) {
-    if (!Pair.hasValue())
-      continue;
-
-    SILValue RefCountedValue = Pair->first;
-
-    // If our SILValue was blotted, skip it. This will be ignored for the rest
-    // of the ARC optimization.
-    if (!RefCountedValue)
-      continue;
-
-    // Then attempt to lookup the corresponding (SILValue, BottomUpState) from
-    // SuccRegion. If we fail to do so, blot this SILValue and continue.
-    //
-    // Since we are already initialized by initSuccBottomUp(), this has the
-    // effect of an intersection.
-    auto Other = SuccRegionState.PtrToBottomUpState.find(RefCountedValue);
-    if (Other == SuccRegionState.PtrToBottomUpState.end()) {
-      PtrToBottomUpState.blot(RefCountedValue);
-      continue;
-    }
-
-    SILValue OtherRefCountedValue = (*Other)->first;
-
-    // If the other ref count value was blotted, blot our value and continue.
-    // This has the effect of an intersection since we already checked earlier
-    // that RefCountedValue was not blotted.
-    if (!OtherRefCountedValue) {
-      PtrToBottomUpState.blot(RefCountedValue);
-      continue;
-    }
-
-    BottomUpRefCountState &RefCountState = Pair->second;
-    BottomUpRefCountState &OtherRefCountState = (*Other)->second;
-
-    // Ok, now we know that the merged set can safely represent a set of
-    // of instructions which together semantically act as one ref count
-    // increment. Merge the two states together.
-    if (!RefCountState.merge(OtherRefCountState)) {
-      PtrToBottomUpState.blot(RefCountedValue);
-    }
-  }
+  // Roots which are not tracked in SuccRegion are dropped. For the others,
+  // merge the two states together. If that fails, the merged set of
+  // instructions cannot act as one ref count increment and we stop tracking
+  // the root.
+  PtrToBottomUpState.intersect(
+      SuccRegionState.PtrToBottomUpState,
+      [](BottomUpRefCountState &RefCountState,
+         const BottomUpRefCountState &OtherRefCountState) {
+        return RefCountState.merge(OtherRefCountState);
+      });
 }
 
 //===---
@@ -104,51 +75,20 @@ void ARCRegionState::initPredTopDown(ARCRegionState &PredRegionState) {
 }
 
 /// Merge in the state of the predecessor basic block.
+///
+/// This is an intersection operation.
 void ARCRegionState::mergePredTopDown(ARCRegionState &PredRegionState) {
-  // For each [(SILValue, TopDownState)] that we are tracking...
-  for (auto &Pair : getTopDownStates()) {
-    if (!Pair.hasValue())
-      continue;
-    SILValue RefCountedValue = Pair->first;
-
-    // If our SILValue was blotted, skip it. This will be ignored in the rest of
-    // the optimizer.
-    if (!RefCountedValue)
-      continue;
-
-    // Then attempt to lookup the corresponding (SILValue, TopDownState) from
-    // PredRegion. If we fail to do so, blot this SILValue and continue.
-    //
-    // Since we are already initialized by initPredTopDown(), this has the
-    // effect of an intersection.
-    auto Other = PredRegionState.PtrToTopDownState.find(RefCountedValue);
-    if (Other == PredRegionState.PtrToTopDownState.end()) {
-      PtrToTopDownState.blot(RefCountedValue);
-      continue;
-    }
-
-    SILValue OtherRefCountedValue = (*Other)->first;
-
-    // If the other ref count value was blotted, blot our value and continue.
-    // This has the effect of an intersection.
-    if (!OtherRefCountedValue) {
-      PtrToTopDownState.blot(RefCountedValue);
-      continue;
-    }
-
-    // Ok, so now we know that the ref counted value we are tracking was not
-    // blotted on either side. Grab the states.
-    TopDownRefCountState &RefCountState = Pair->second;
-    TopDownRefCountState &OtherRefCountState = (*Other)->second;
-
-    // Attempt to merge Other into this ref count state. If we fail, blot this
-    // ref counted value and continue.
-    if (!RefCountState.merge(OtherRefCountState)) {
-      DEBUG(llvm::dbgs() << "Failed to merge!\n");
-      PtrToTopDownState.blot(RefCountedValue);
-      continue;
-    }
-  }
+  // Roots which are not tracked in PredRegion are dropped. For the others,
+  // attempt to merge the two states. If we fail, stop tracking the root.
+  PtrToTopDownState.intersect(
+      PredRegionState.PtrToTopDownState,
+      [](TopDownRefCountState &RefCountState,
+         const TopDownRefCountState &OtherRefCountState) {
+        if (RefCountState.merge(OtherRefCountState))
+          return true;
+        DEBUG(llvm::dbgs() << "Failed to merge!\n");
+        return false;
+      });
 }
 
 //===---
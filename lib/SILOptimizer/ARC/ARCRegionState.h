@@ -14,6 +14,7 @@
 #define SWIFT_SILOPTIMIZER_PASSMANAGER_ARC_ARCREGIONSTATE_H
 
 #include "GlobalLoopARCSequenceDataflow.h"
+#include "RefCountStateMap.h"
 #include "swift/Basic/NullablePtr.h"
 
 namespace swift {
@@ -26,9 +27,8 @@ class RCIdentityFunctionInfo;
 /// \brief Per-Region state.
 class ARCRegionState {
 public:
-  // TODO: These are relatively expensive, find something else to use here.
-  using TopDownMapTy = SmallBlotMapVector<SILValue, TopDownRefCountState, 4>;
-  using BottomUpMapTy = SmallBlotMapVector<SILValue, BottomUpRefCountState, 4>;
+  using TopDownMapTy = RefCountStateMap<TopDownRefCountState>;
+  using BottomUpMapTy = RefCountStateMap<BottomUpRefCountState>;
 
 private:
   /// The region that this ARCRegionState summarizes information for.
@@ -65,7 +65,7 @@ private:
   llvm::SmallVector<SILInstruction *, 4> SummarizedInterestingInsts;
 
 public:
-  ARCRegionState(LoopRegion *R, bool AllowsLeaks);
+  ARCRegionState(LoopRegion *R, bool AllowsLeaks, RCRootIndex &Roots);
 
   /// Is this Region from which we can leak memory safely?
   bool allowsLeaks() const { return AllowsLeaks; }
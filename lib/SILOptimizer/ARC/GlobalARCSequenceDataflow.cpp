@@ -401,10 +401,10 @@ ARCSequenceDataflowEvaluator::ARCSequenceDataflowEvaluator(
     BlotMapVector<SILInstruction *, BottomUpRefCountState> &IncToDecStateMap)
     : F(F), AA(AA), POA(POA), RCIA(RCIA), EAFI(EAFI),
       DecToIncStateMap(DecToIncStateMap), IncToDecStateMap(IncToDecStateMap),
-      Allocator(), SetFactory(Allocator),
+      Allocator(), SetFactory(Allocator), RCRoots(),
       // We use a malloced pointer here so we don't need to expose
       // ARCBBStateInfo in the header.
-      BBStateInfo(new ARCBBStateInfo(&F, POA, PTFI)) {}
+      BBStateInfo(new ARCBBStateInfo(&F, POA, PTFI, RCRoots)) {}
 
 bool ARCSequenceDataflowEvaluator::run(bool FreezeOwnedReleases) {
   bool NestingDetected = processBottomUp(FreezeOwnedReleases);
@@ -14,6 +14,7 @@
 #define SWIFT_SILOPTIMIZER_PASSMANAGER_ARC_GLOBALARCSEQUENCEDATAFLOW_H
 
 #include "RefCountState.h"
+#include "RefCountStateMap.h"
 #include "swift/SILOptimizer/Analysis/PostOrderAnalysis.h"
 #include "swift/SILOptimizer/Analysis/ProgramTerminationAnalysis.h"
 #include "swift/Basic/BlotMapVector.h"
@@ -66,6 +67,9 @@ private:
   llvm::BumpPtrAllocator Allocator;
   ImmutablePointerSetFactory<SILInstruction> SetFactory;
 
+  /// The numbering of the RC identity roots tracked in the BB states.
+  RCRootIndex RCRoots;
+
   /// Stashed BB information.
   ARCBBStateInfo *BBStateInfo;
 
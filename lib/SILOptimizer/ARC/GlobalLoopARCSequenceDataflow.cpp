@@ -261,7 +261,7 @@ LoopARCSequenceDataflowEvaluator::LoopARCSequenceDataflowEvaluator(
     bool AllowsLeaks = false;
     if (R->isBlock())
       AllowsLeaks |= PTFI->isProgramTerminatingBlock(R->getBlock());
-    RegionStateInfo[R] = new (Allocator) ARCRegionState(R, AllowsLeaks);
+    RegionStateInfo[R] = new (Allocator) ARCRegionState(R, AllowsLeaks, RCRoots);
   }
 }
 
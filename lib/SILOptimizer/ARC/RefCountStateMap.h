@@ -0,0 +1,212 @@
+//===--- RefCountStateMap.h - Per-block ref count states --------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// The ARC sequence dataflow keeps a map from RC identity roots to ref count
+// states for every block (or region) and copies and intersects these maps at
+// every edge. To make this cheap, the roots of a function are numbered densely
+// and the maps are stored as vectors sorted by root number, together with a bit
+// vector of the tracked roots. Intersecting two maps then is a word-wide
+// bit vector operation followed by a linear merge instead of a hash lookup per
+// tracked root.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_SILOPTIMIZER_PASSMANAGER_ARC_REFCOUNTSTATEMAP_H
+#define SWIFT_SILOPTIMIZER_PASSMANAGER_ARC_REFCOUNTSTATEMAP_H
+
+#include "swift/SIL/SILValue.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallVector.h"
+#include <algorithm>
+
+namespace swift {
+
+/// Assigns dense indices to the RC identity roots of a function.
+///
+/// Indices are handed out in the order in which roots are first seen by the
+/// dataflow, so iterating a RefCountStateMap in index order is deterministic.
+class RCRootIndex {
+  llvm::DenseMap<SILValue, unsigned> RootToIndex;
+
+public:
+  /// Returns the index of \p Root, assigning a new one if necessary.
+  unsigned getIndex(SILValue Root) {
+    unsigned NewIndex = RootToIndex.size();
+    return RootToIndex.insert({Root, NewIndex}).first->second;
+  }
+
+  /// Returns the index of \p Root or None if it was never seen.
+  Optional<unsigned> lookupIndex(SILValue Root) const {
+    auto Iter = RootToIndex.find(Root);
+    if (Iter == RootToIndex.end())
+      return None;
+    return Iter->second;
+  }
+
+  unsigned size() const { return RootToIndex.size(); }
+};
+
+/// A map from RC identity roots to ref count states.
+///
+/// The interface mirrors SmallBlotMapVector: iteration yields optional
+/// (root, state) pairs and blotted entries are None.
+template <typename StateTy>
+class RefCountStateMap {
+public:
+  using EntryTy = Optional<std::pair<SILValue, StateTy>>;
+  using iterator = typename llvm::SmallVectorImpl<EntryTy>::iterator;
+  using const_iterator = typename llvm::SmallVectorImpl<EntryTy>::const_iterator;
+
+private:
+  /// The numbering of the roots, shared by all maps of a function.
+  RCRootIndex *Roots = nullptr;
+
+  /// Bit I is set if the root with index I has a non-blotted entry.
+  llvm::BitVector Tracked;
+
+  /// The root index of each entry, sorted in ascending order.
+  llvm::SmallVector<unsigned, 4> Indices;
+
+  /// The entries, parallel to Indices.
+  llvm::SmallVector<EntryTy, 4> Entries;
+
+  /// Returns the position of the entry for root index \p Idx, or the position
+  /// where it would have to be inserted.
+  unsigned getPosition(unsigned Idx) const {
+    // New roots usually get the highest index so far.
+    if (Indices.empty() || Indices.back() < Idx)
+      return Indices.size();
+    return std::lower_bound(Indices.begin(), Indices.end(), Idx) -
+           Indices.begin();
+  }
+
+  /// Returns true if the root with index \p Idx has a non-blotted entry.
+  bool isTracked(unsigned Idx) const {
+    return Idx < Tracked.size() && Tracked.test(Idx);
+  }
+
+  /// Removes blotted entries.
+  void compact() {
+    unsigned NewSize = 0;
+    for (unsigned Pos = 0, E = Entries.size(); Pos != E; ++Pos) {
+      if (!Entries[Pos])
+        continue;
+      if (Pos != NewSize) {
+        Indices[NewSize] = Indices[Pos];
+        Entries[NewSize] = std::move(Entries[Pos]);
+      }
+      ++NewSize;
+    }
+    Indices.resize(NewSize);
+    Entries.resize(NewSize);
+  }
+
+public:
+  RefCountStateMap() = default;
+
+  void setRootIndex(RCRootIndex &NewRoots) { Roots = &NewRoots; }
+
+  iterator begin() { return Entries.begin(); }
+  iterator end() { return Entries.end(); }
+  const_iterator begin() const { return Entries.begin(); }
+  const_iterator end() const { return Entries.end(); }
+
+  /// Returns the state for \p Root, inserting a default state if it is not
+  /// tracked yet.
+  StateTy &operator[](SILValue Root) {
+    assert(Roots && "map was not initialized");
+    unsigned Idx = Roots->getIndex(Root);
+    if (Idx >= Tracked.size())
+      Tracked.resize(Roots->size());
+
+    unsigned Pos = getPosition(Idx);
+    if (Pos != Indices.size() && Indices[Pos] == Idx) {
+      // Reuse a blotted entry.
+      if (!Entries[Pos]) {
+        Entries[Pos] = std::make_pair(Root, StateTy());
+        Tracked.set(Idx);
+      }
+      return Entries[Pos]->second;
+    }
+    Indices.insert(Indices.begin() + Pos, Idx);
+    Entries.insert(Entries.begin() + Pos, std::make_pair(Root, StateTy()));
+    Tracked.set(Idx);
+    return Entries[Pos]->second;
+  }
+
+  iterator find(SILValue Root) {
+    Optional<unsigned> Idx = Roots ? Roots->lookupIndex(Root) : None;
+    if (!Idx || !isTracked(*Idx))
+      return end();
+    return begin() + getPosition(*Idx);
+  }
+
+  const_iterator find(SILValue Root) const {
+    return const_cast<RefCountStateMap &>(*this).find(Root);
+  }
+
+  /// Marks the entry of \p Root as removed without invalidating iterators.
+  void blot(SILValue Root) {
+    Optional<unsigned> Idx = Roots ? Roots->lookupIndex(Root) : None;
+    if (!Idx || !isTracked(*Idx))
+      return;
+    Entries[getPosition(*Idx)] = None;
+    Tracked.reset(*Idx);
+  }
+
+  /// Intersects this map with \p Other. The states of roots which are tracked
+  /// in both maps are merged with \p Merge. If \p Merge returns false, the root
+  /// is removed from this map.
+  template <typename MergeFn>
+  void intersect(const RefCountStateMap &Other, MergeFn Merge) {
+    // Drop the roots which are not tracked in Other, a word at a time.
+    Tracked &= Other.Tracked;
+
+    unsigned OtherPos = 0;
+    for (unsigned Pos = 0, E = Entries.size(); Pos != E; ++Pos) {
+      if (!Entries[Pos])
+        continue;
+      unsigned Idx = Indices[Pos];
+      if (!Tracked.test(Idx)) {
+        Entries[Pos] = None;
+        continue;
+      }
+
+      // Both maps are sorted by root index, so Other's entry is ahead.
+      while (Other.Indices[OtherPos] < Idx)
+        ++OtherPos;
+      assert(Other.Indices[OtherPos] == Idx && Other.Entries[OtherPos] &&
+             "tracked bit without entry");
+
+      if (!Merge(Entries[Pos]->second, Other.Entries[OtherPos]->second)) {
+        Entries[Pos] = None;
+        Tracked.reset(Idx);
+      }
+    }
+    compact();
+  }
+
+  void clear() {
+    Tracked.reset();
+    Indices.clear();
+    Entries.clear();
+  }
+
+  unsigned size() const { return Tracked.count(); }
+  bool empty() const { return Tracked.none(); }
+};
+
+} // end swift namespace
+
+#endif
@@ -24,6 +24,7 @@
 #include "swift/SIL/SILFunction.h"
 #include "swift/SIL/SILModule.h"
 #include "swift/SIL/InstructionUtils.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/raw_ostream.h"
@@ -33,8 +34,15 @@ using namespace swift;
 
 // The AliasAnalysis Cache must not grow beyond this size.
 // We limit the size of the AA cache to 2**14 because we want to limit the
-// memory usage of this cache.
-static const int AliasAnalysisMaxCacheSize = 16384;
+// memory usage of this cache. When it is full, the least recently used entries
+// are evicted.
+static const unsigned AliasAnalysisMaxCacheSize = 16384;
+
+// The MemoryBehavior Cache must not grow beyond this size.
+static const unsigned MemoryBehaviorAnalysisMaxCacheSize = 16384;
+
+STATISTIC(NumAliasCacheHits, "Number of alias queries answered by the cache");
+STATISTIC(NumAliasCacheMisses, "Number of alias queries not in the cache");
 
 
 //===----------------------------------------------------------------------===//
@@ -537,26 +545,18 @@ bool AliasAnalysis::typesMayAlias(SILType T1, SILType T2) {
 /// to disambiguate the two values.
 AliasResult AliasAnalysis::alias(SILValue V1, SILValue V2,
                                  SILType TBAAType1, SILType TBAAType2) {
-  AliasKeyTy Key = toAliasKey(V1, V2, TBAAType1, TBAAType2);
+  CacheKey Key = toAliasKey(V1, V2, TBAAType1, TBAAType2);
 
   // Check if we've already computed this result.
-  auto It = AliasCache.find(Key);
-  if (It != AliasCache.end()) {
-    return It->second;
-  }
-
-  // Flush the cache if the size of the cache is too large.
-  if (AliasCache.size() > AliasAnalysisMaxCacheSize) {
-    AliasCache.clear();
-    AliasValueBaseToIndex.clear();
-
-    // Key is no longer valid as we cleared the AliasValueBaseToIndex.
-    Key = toAliasKey(V1, V2, TBAAType1, TBAAType2);
+  if (AliasResult *Cached = AliasCache.lookup(Key)) {
+    ++NumAliasCacheHits;
+    return *Cached;
   }
+  ++NumAliasCacheMisses;
 
   // Calculate the aliasing result and store it in the cache.
   auto Result = aliasInner(V1, V2, TBAAType1, TBAAType2);
-  AliasCache[Key] = Result;
+  AliasCache.insert(Key, Result);
   return Result;
 }
 
@@ -756,6 +756,11 @@ bool swift::isLetPointer(SILValue V) {
   return false;
 }
 
+AliasAnalysis::AliasAnalysis(SILModule *M)
+    : SILAnalysis(AnalysisKind::Alias), Mod(M), SEA(nullptr), EA(nullptr),
+      AliasCache(AliasAnalysisMaxCacheSize),
+      MemoryBehaviorCache(MemoryBehaviorAnalysisMaxCacheSize) {}
+
 void AliasAnalysis::initialize(SILPassManager *PM) {
   SEA = PM->getAnalysis<SideEffectAnalysis>();
   EA = PM->getAnalysis<EscapeAnalysis>();
@@ -765,15 +770,37 @@ SILAnalysis *swift::createAliasAnalysis(SILModule *M) {
   return new AliasAnalysis(M);
 }
 
-AliasKeyTy AliasAnalysis::toAliasKey(SILValue V1, SILValue V2,
-                                     SILType Type1, SILType Type2) {
-  size_t idx1 = AliasValueBaseToIndex.getIndex(V1);
-  assert(idx1 != std::numeric_limits<size_t>::max() &&
-         "~0 index reserved for empty/tombstone keys");
-  size_t idx2 = AliasValueBaseToIndex.getIndex(V2);
-  assert(idx2 != std::numeric_limits<size_t>::max() &&
-         "~0 index reserved for empty/tombstone keys");
-  void *t1 = Type1.getOpaqueValue();
-  void *t2 = Type2.getOpaqueValue();
-  return {idx1, idx2, t1, t2};
+void AliasAnalysis::invalidate(SILFunction *F,
+                               SILAnalysis::InvalidationKind K) {
+  // Give the values of F new indices: the cached results for the old indices
+  // become unreachable and are evicted over time.
+  for (auto &BB : *F) {
+    for (auto *Arg : BB.getArguments())
+      ValueToIndex.invalidateValue(Arg);
+    for (auto &I : BB)
+      ValueToIndex.invalidateValue(&I);
+  }
+}
+
+uint64_t AliasAnalysis::toValuePairKey(SILValue V1, SILValue V2) {
+  uint32_t idx1 = ValueToIndex.getIndex(V1);
+  uint32_t idx2 = ValueToIndex.getIndex(V2);
+  // Index ~0 is reserved for the empty and tombstone keys of the caches. Start
+  // over if the indices are exhausted.
+  if (idx1 == std::numeric_limits<uint32_t>::max() ||
+      idx2 == std::numeric_limits<uint32_t>::max()) {
+    invalidate(InvalidationKind::Everything);
+    idx1 = ValueToIndex.getIndex(V1);
+    idx2 = ValueToIndex.getIndex(V2);
+  }
+  return (uint64_t(idx1) << 32) | idx2;
+}
+
+AliasAnalysis::CacheKey AliasAnalysis::toAliasKey(SILValue V1, SILValue V2,
+                                                  SILType Type1,
+                                                  SILType Type2) {
+  uint64_t Values = toValuePairKey(V1, V2);
+  uint32_t t1 = TBAATypeToIndex.getIndex(Type1.getOpaqueValue());
+  uint32_t t2 = TBAATypeToIndex.getIndex(Type2.getOpaqueValue());
+  return {Values, (uint64_t(t1) << 32) | t2};
 }
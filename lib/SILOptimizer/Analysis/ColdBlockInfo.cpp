@@ -107,7 +107,8 @@ ColdBlockInfo::BranchHint ColdBlockInfo::getBranchHint(SILValue Cond,
 }
 
 /// \return true if the CFG edge FromBB->ToBB is directly gated by a _slowPath
-/// branch hint.
+/// branch hint, or if the profile shows that the edge was never taken while
+/// the other edge was.
 bool ColdBlockInfo::isSlowPath(const SILBasicBlock *FromBB,
                                const SILBasicBlock *ToBB,
                                int recursionDepth) {
@@ -115,6 +116,14 @@ bool ColdBlockInfo::isSlowPath(const SILBasicBlock *FromBB,
   if (!CBI)
     return false;
 
+  if (auto Counts = CBI->getEdgeCounts()) {
+    uint64_t ToCount = Counts->first, OtherCount = Counts->second;
+    if (ToBB == CBI->getFalseBB())
+      std::swap(ToCount, OtherCount);
+    if (ToCount == 0 && OtherCount != 0)
+      return true;
+  }
+
   SILValue C = getCondition(CBI->getCondition());
 
   BranchHint hint = getBranchHint(C, recursionDepth);
@@ -19,11 +19,17 @@
 #include "swift/SILOptimizer/Utils/Local.h"
 #include "swift/SIL/SILArgument.h"
 #include "swift/SIL/DebugUtils.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/GraphWriter.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace swift;
 
+STATISTIC(NumSummariesReused,
+          "Number of recomputed functions whose callers were kept");
+STATISTIC(NumSummariesChanged,
+          "Number of recomputed functions whose callers were invalidated");
+
 static bool isProjection(ValueBase *V) {
   switch (V->getKind()) {
     case ValueKind::IndexAddrInst:
@@ -1694,6 +1700,11 @@ void EscapeAnalysis::recompute(FunctionInfo *Initial) {
       FInfo->Graph.computeUsePoints();
       FInfo->Graph.verify();
       FInfo->SummaryGraph.verify();
+
+      // Remember what the callers see, so that a later invalidation can tell
+      // whether they have to be recomputed.
+      FInfo->Fingerprint.clear();
+      computeSummaryFingerprint(FInfo, FInfo->Fingerprint);
     }
   }
 }
@@ -1927,6 +1938,9 @@ bool EscapeAnalysis::canPointToSameMemory(SILValue V1, SILValue V2) {
 
 bool EscapeAnalysis::canParameterEscape(FullApplySite FAS, int ParamIdx,
                                         bool checkContentOfIndirectParam) {
+  if (!PendingInvalidations.empty())
+    flushPendingInvalidations();
+
   CalleeList Callees = BCA->getCalleeList(FAS);
   if (!Callees.allCalleesVisible())
     return true;
@@ -1954,15 +1968,105 @@ bool EscapeAnalysis::canParameterEscape(FullApplySite FAS, int ParamIdx,
   return false;
 }
 
+void EscapeAnalysis::computeSummaryFingerprint(FunctionInfo *FInfo,
+                                               SummaryFingerprint &FP) {
+  ConnectionGraph *SummaryGraph = &FInfo->SummaryGraph;
+  llvm::DenseMap<CGNode *, unsigned> NodeNumbers;
+  llvm::SmallVector<CGNode *, 16> WorkList;
+
+  // Number the nodes in the order in which they are reached. 0 stands for a
+  // missing node.
+  auto getNumber = [&](CGNode *Node) -> unsigned {
+    if (!Node)
+      return 0;
+    auto Iter = NodeNumbers.insert({Node, NodeNumbers.size() + 1});
+    if (Iter.second)
+      WorkList.push_back(Node);
+    return Iter.first->second;
+  };
+
+  // The roots are the nodes which mergeCalleeGraph() maps into the caller:
+  // the parameters and the return value.
+  SILFunction *F = SummaryGraph->F;
+  for (SILArgument *Arg : F->getArguments())
+    FP.push_back(getNumber(SummaryGraph->getNodeOrNull(Arg, this)));
+  FP.push_back(getNumber(SummaryGraph->getReturnNodeOrNull()));
+
+  for (unsigned Idx = 0; Idx < WorkList.size(); ++Idx) {
+    CGNode *Node = WorkList[Idx];
+    FP.push_back(unsigned(Node->Type));
+    FP.push_back(unsigned(Node->State));
+    FP.push_back(Node->pointsToIsEdge);
+    FP.push_back(getNumber(Node->pointsTo));
+    FP.push_back(Node->defersTo.size());
+    for (CGNode *Def : Node->defersTo)
+      FP.push_back(getNumber(Def));
+  }
+}
+
+void EscapeAnalysis::flushPendingInvalidations() {
+  while (!PendingInvalidations.empty()) {
+    FunctionInfo *FInfo = PendingInvalidations.front().first;
+    SummaryFingerprint OldFP = std::move(PendingInvalidations.front().second);
+    PendingInvalidations.erase(PendingInvalidations.begin());
+
+    if (!FInfo->isValid())
+      recompute(FInfo);
+
+    if (FInfo->Fingerprint == OldFP) {
+      ++NumSummariesReused;
+      DEBUG(llvm::dbgs() << "  keep callers of " << FInfo->Graph.F->getName()
+                         << '\n');
+      continue;
+    }
+
+    // The callers were built with the old summary graph.
+    ++NumSummariesChanged;
+    DEBUG(llvm::dbgs() << "  invalidate callers of " <<
+          FInfo->Graph.F->getName() << '\n');
+    // Collect the callers first: in case of recursion the invalidation may
+    // reach FInfo and clear its caller list.
+    llvm::SmallVector<FunctionInfo *, 8> Callers;
+    for (const auto &E : FInfo->getCallers()) {
+      if (E.isValid())
+        Callers.push_back(E.Caller);
+    }
+    for (FunctionInfo *Caller : Callers)
+      invalidateIncludingAllCallers(Caller);
+  }
+}
+
 void EscapeAnalysis::invalidate(InvalidationKind K) {
   Function2Info.clear();
+  PendingInvalidations.clear();
   Allocator.DestroyAll();
   DEBUG(llvm::dbgs() << "invalidate all\n");
 }
 
 void EscapeAnalysis::invalidate(SILFunction *F, InvalidationKind K) {
+  FunctionInfo *FInfo = Function2Info.lookup(F);
+  if (!FInfo || !FInfo->isValid())
+    return;
+
+  DEBUG(llvm::dbgs() << "  invalidate " << FInfo->Graph.F->getName() << '\n');
+
+  // Only the graph of F itself is invalid now. Its callers stay valid as long
+  // as the recomputed summary graph of F turns out to be the same as before.
+  // This is checked lazily in flushPendingInvalidations().
+  // The summary graph itself may already have been modified by the
+  // transformation which requested the invalidation (see
+  // handleDeleteNotification), so compare against the fingerprint which was
+  // taken when it was computed. If F is already pending, keep the older
+  // fingerprint: that's the one the callers were built with.
+  PendingInvalidations.insert({FInfo, FInfo->Fingerprint});
+  invalidateOnlyFunction(FInfo);
+}
+
+void EscapeAnalysis::invalidateForDeadFunction(SILFunction *F,
+                                               InvalidationKind K) {
   if (FunctionInfo *FInfo = Function2Info.lookup(F)) {
-    DEBUG(llvm::dbgs() << "  invalidate " << FInfo->Graph.F->getName() << '\n');
+    DEBUG(llvm::dbgs() << "  invalidate dead " << F->getName() << '\n');
+    PendingInvalidations.erase(FInfo);
     invalidateIncludingAllCallers(FInfo);
   }
 }
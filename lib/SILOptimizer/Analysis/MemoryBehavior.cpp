@@ -17,14 +17,15 @@
 #include "swift/SILOptimizer/Analysis/SideEffectAnalysis.h"
 #include "swift/SILOptimizer/Analysis/ValueTracking.h"
 #include "swift/SIL/SILVisitor.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Debug.h"
 
 using namespace swift;
 
-// The MemoryBehavior Cache must not grow beyond this size.
-// We limit the size of the MB cache to 2**14 because we want to limit the
-// memory usage of this cache.
-static const int MemoryBehaviorAnalysisMaxCacheSize = 16384;
+STATISTIC(NumMemoryBehaviorCacheHits,
+          "Number of memory behavior queries answered by the cache");
+STATISTIC(NumMemoryBehaviorCacheMisses,
+          "Number of memory behavior queries not in the cache");
 
 //===----------------------------------------------------------------------===//
 //                       Memory Behavior Implementation
@@ -308,26 +309,17 @@ MemBehavior MemoryBehaviorVisitor::visitSetDeallocatingInst(SetDeallocatingInst
 MemBehavior
 AliasAnalysis::computeMemoryBehavior(SILInstruction *Inst, SILValue V,
                                      RetainObserveKind InspectionMode) {
-  MemBehaviorKeyTy Key = toMemoryBehaviorKey(SILValue(Inst), V,
-                                             InspectionMode);
+  CacheKey Key = toMemoryBehaviorKey(SILValue(Inst), V, InspectionMode);
   // Check if we've already computed this result.
-  auto It = MemoryBehaviorCache.find(Key);
-  if (It != MemoryBehaviorCache.end()) {
-    return It->second;
-  }
-
-  // Flush the cache if the size of the cache is too large.
-  if (MemoryBehaviorCache.size() > MemoryBehaviorAnalysisMaxCacheSize) {
-    MemoryBehaviorCache.clear();
-    MemoryBehaviorValueBaseToIndex.clear();
-
-    // Key is no longer valid as we cleared the MemoryBehaviorValueBaseToIndex.
-    Key = toMemoryBehaviorKey(SILValue(Inst), V, InspectionMode);
+  if (MemBehavior *Cached = MemoryBehaviorCache.lookup(Key)) {
+    ++NumMemoryBehaviorCacheHits;
+    return *Cached;
   }
+  ++NumMemoryBehaviorCacheMisses;
 
   // Calculate the aliasing result and store it in the cache.
   auto Result = computeMemoryBehaviorInner(Inst, V, InspectionMode);
-  MemoryBehaviorCache[Key] = Result;
+  MemoryBehaviorCache.insert(Key, Result);
   return Result;
 }
 
@@ -340,13 +332,8 @@ AliasAnalysis::computeMemoryBehaviorInner(SILInstruction *Inst, SILValue V,
   return MemoryBehaviorVisitor(this, SEA, EA, V, InspectionMode).visit(Inst);
 }
 
-MemBehaviorKeyTy AliasAnalysis::toMemoryBehaviorKey(SILValue V1, SILValue V2,
-                                                    RetainObserveKind M) {
-  size_t idx1 = MemoryBehaviorValueBaseToIndex.getIndex(V1);
-  assert(idx1 != std::numeric_limits<size_t>::max() &&
-         "~0 index reserved for empty/tombstone keys");
-  size_t idx2 = MemoryBehaviorValueBaseToIndex.getIndex(V2);
-  assert(idx2 != std::numeric_limits<size_t>::max() &&
-         "~0 index reserved for empty/tombstone keys");
-  return {idx1, idx2, M};
+AliasAnalysis::CacheKey
+AliasAnalysis::toMemoryBehaviorKey(SILValue V1, SILValue V2,
+                                   RetainObserveKind M) {
+  return {toValuePairKey(V1, V2), uint64_t(M)};
 }
@@ -479,6 +479,10 @@ void EagerSpecializerTransform::run() {
     for (auto *SA : F.getSpecializeAttrs()) {
       ReInfoVec.emplace_back(&F, SA->getSubstitutions());
       auto *NewFunc = eagerSpecialize(&F, *SA, ReInfoVec.back());
+      // Export the specializations of public functions, so that clients can
+      // call them directly (see UsePrespecialized).
+      if (NewFunc && hasPublicVisibility(F.getLinkage()))
+        NewFunc->setKeepAsPublic(true);
       SpecializedFuncs.push_back(NewFunc);
     }
 
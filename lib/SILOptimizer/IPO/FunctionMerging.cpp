@@ -0,0 +1,403 @@
+//===--- FunctionMerging.cpp - Merge identical SIL functions --------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Specialization, function signature optimization and thunk generation often
+// create functions with identical bodies, e.g. the same specialization
+// created under different names or two reabstraction thunks for the same
+// conversion. This pass finds such functions and replaces all references to
+// the duplicates with a reference to a single copy.
+//
+// Functions are first grouped by a structural hash of their type and
+// instructions. Within a group, two functions are identical if their blocks
+// and instructions correspond one to one: every instruction has the same
+// kind, type and state as its counterpart, and its operands and successors
+// are the corresponding values and blocks of the other function.
+//
+// Functions which only differ in the types they operate on are not merged,
+// and there is no hash summary to fold functions across object files. Both
+// are left to LLVMMergeFunctions and the linker.
+//
+// Unlike LLVM's function merging, which runs on the LLVM IR of one frontend
+// job, this pass sees the whole module in whole-module compilation and runs
+// before IRGen, so the duplicates don't need to be lowered at all.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "sil-function-merging"
+#include "swift/SIL/SILBuilder.h"
+#include "swift/SIL/SILFunction.h"
+#include "swift/SIL/SILModule.h"
+#include "swift/SILOptimizer/PassManager/Passes.h"
+#include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+
+using namespace swift;
+
+STATISTIC(NumFunctionsMerged, "Number of identical functions merged");
+STATISTIC(NumInstsMerged, "Number of instructions in merged functions");
+
+namespace {
+
+/// Compares the bodies of two functions. Blocks and values are matched by
+/// their position, and each instruction is compared with its counterpart
+/// under this mapping.
+class FunctionComparator {
+  SILFunction *F1;
+  SILFunction *F2;
+
+  /// Maps the blocks, arguments and instructions of F1 to those of F2 at the
+  /// same position.
+  llvm::DenseMap<const SILBasicBlock *, const SILBasicBlock *> BlockMap;
+  llvm::DenseMap<const ValueBase *, const ValueBase *> ValueMap;
+
+  /// Returns true if \p V1 in F1 corresponds to \p V2 in F2.
+  bool isEqual(SILValue V1, SILValue V2) const {
+    auto Iter = ValueMap.find(V1);
+    if (Iter != ValueMap.end())
+      return Iter->second == V2;
+    // Values which are not defined in the function, i.e. undef.
+    return V1 == V2;
+  }
+
+  bool isEqual(const SILBasicBlock *BB1, const SILBasicBlock *BB2) const {
+    return BlockMap.lookup(BB1) == BB2;
+  }
+
+  /// Builds the position-wise mapping between the blocks and values of F1 and
+  /// F2. Returns false if their shapes differ.
+  bool mapBlocksAndValues() {
+    if (F1->size() != F2->size())
+      return false;
+    for (auto BI1 = F1->begin(), BI2 = F2->begin(), BE = F1->end();
+         BI1 != BE; ++BI1, ++BI2) {
+      if (BI1->getNumArguments() != BI2->getNumArguments())
+        return false;
+      BlockMap[&*BI1] = &*BI2;
+      for (unsigned Idx = 0, E = BI1->getNumArguments(); Idx != E; ++Idx) {
+        SILArgument *Arg1 = BI1->getArgument(Idx);
+        SILArgument *Arg2 = BI2->getArgument(Idx);
+        if (Arg1->getType() != Arg2->getType())
+          return false;
+        ValueMap[Arg1] = Arg2;
+      }
+      auto II1 = BI1->begin(), IE1 = BI1->end();
+      auto II2 = BI2->begin(), IE2 = BI2->end();
+      for (; II1 != IE1 && II2 != IE2; ++II1, ++II2)
+        ValueMap[&*II1] = &*II2;
+      if (II1 != IE1 || II2 != IE2)
+        return false;
+    }
+    return true;
+  }
+
+  /// Compares the terminators \p T1 and \p T2, whose kinds, operands and
+  /// types are already known to be equal.
+  bool compareTerminators(TermInst *T1, TermInst *T2) const {
+    auto Succs1 = T1->getSuccessors();
+    auto Succs2 = T2->getSuccessors();
+    if (Succs1.size() != Succs2.size())
+      return false;
+    for (unsigned Idx = 0, E = Succs1.size(); Idx != E; ++Idx)
+      if (!isEqual(Succs1[Idx].getBB(), Succs2[Idx].getBB()))
+        return false;
+
+    switch (T1->getKind()) {
+    case ValueKind::ReturnInst:
+    case ValueKind::ThrowInst:
+    case ValueKind::UnreachableInst:
+    case ValueKind::BranchInst:
+    case ValueKind::CondBranchInst:
+      return true;
+    case ValueKind::SwitchEnumInst:
+    case ValueKind::SwitchEnumAddrInst: {
+      auto *SEI1 = cast<SwitchEnumInstBase>(T1);
+      auto *SEI2 = cast<SwitchEnumInstBase>(T2);
+      if (SEI1->getNumCases() != SEI2->getNumCases() ||
+          SEI1->hasDefault() != SEI2->hasDefault())
+        return false;
+      for (unsigned Idx = 0, E = SEI1->getNumCases(); Idx != E; ++Idx)
+        if (SEI1->getCase(Idx).first != SEI2->getCase(Idx).first)
+          return false;
+      return true;
+    }
+    default:
+      // Don't bother with the state of other terminators.
+      return false;
+    }
+  }
+
+  bool compareInstructions(SILInstruction *I1, SILInstruction *I2) const {
+    if (I1->getKind() != I2->getKind() ||
+        I1->getNumOperands() != I2->getNumOperands() ||
+        I1->getType() != I2->getType())
+      return false;
+
+    auto OpEqual = [this](SILValue Op1, SILValue Op2) -> bool {
+      return isEqual(Op1, Op2);
+    };
+
+    if (auto *T1 = dyn_cast<TermInst>(I1)) {
+      for (unsigned Idx = 0, E = I1->getNumOperands(); Idx != E; ++Idx)
+        if (!OpEqual(I1->getOperand(Idx), I2->getOperand(Idx)))
+          return false;
+      return compareTerminators(T1, cast<TermInst>(I2));
+    }
+
+    // A recursive reference is equal to the recursive reference of the other
+    // function.
+    if (auto *FRI1 = dyn_cast<FunctionRefInst>(I1)) {
+      SILFunction *Callee1 = FRI1->getReferencedFunction();
+      SILFunction *Callee2 = cast<FunctionRefInst>(I2)->getReferencedFunction();
+      if (Callee1 == F1)
+        return Callee2 == F2;
+      return Callee1 == Callee2;
+    }
+
+    // The identity comparer compares the operands of these instructions by
+    // identity.
+    if (auto *SI1 = dyn_cast<StoreInst>(I1)) {
+      auto *SI2 = cast<StoreInst>(I2);
+      return OpEqual(SI1->getSrc(), SI2->getSrc()) &&
+             OpEqual(SI1->getDest(), SI2->getDest()) &&
+             SI1->getOwnershipQualifier() == SI2->getOwnershipQualifier();
+    }
+    if (auto *REA1 = dyn_cast<RefElementAddrInst>(I1)) {
+      auto *REA2 = cast<RefElementAddrInst>(I2);
+      return REA1->getField() == REA2->getField() &&
+             OpEqual(REA1->getOperand(), REA2->getOperand());
+    }
+    if (auto *CMI1 = dyn_cast<ClassMethodInst>(I1)) {
+      auto *CMI2 = cast<ClassMethodInst>(I2);
+      return CMI1->getMember() == CMI2->getMember() &&
+             OpEqual(CMI1->getOperand(), CMI2->getOperand());
+    }
+
+    // Instructions which the identity comparer doesn't handle are never
+    // considered equal.
+    return I1->isIdenticalTo(I2, OpEqual);
+  }
+
+public:
+  FunctionComparator(SILFunction *F1, SILFunction *F2) : F1(F1), F2(F2) {}
+
+  /// Returns true if the bodies of F1 and F2 are identical.
+  bool compare() {
+    if (!mapBlocksAndValues())
+      return false;
+    for (auto BI1 = F1->begin(), BI2 = F2->begin(), BE = F1->end();
+         BI1 != BE; ++BI1, ++BI2) {
+      for (auto II1 = BI1->begin(), II2 = BI2->begin(), IE = BI1->end();
+           II1 != IE; ++II1, ++II2)
+        if (!compareInstructions(&*II1, &*II2))
+          return false;
+    }
+    return true;
+  }
+};
+
+class FunctionMerging : public SILModuleTransform {
+  /// All function_ref instructions of the module, by referenced function.
+  llvm::DenseMap<SILFunction *, SmallVector<FunctionRefInst *, 4>> FuncRefs;
+
+  /// Returns a hash of the structure of \p F, which is equal for identical
+  /// functions. Operands are hashed by the position of their definition, so
+  /// the hash does not depend on the names of values or of \p F itself.
+  static llvm::hash_code hashFunction(SILFunction *F) {
+    llvm::DenseMap<const ValueBase *, unsigned> ValueNumbers;
+    llvm::DenseMap<const SILBasicBlock *, unsigned> BlockNumbers;
+    unsigned NumValues = 0, NumBlocks = 0;
+    for (auto &BB : *F) {
+      BlockNumbers[&BB] = NumBlocks++;
+      for (SILArgument *Arg : BB.getArguments())
+        ValueNumbers[Arg] = NumValues++;
+      for (auto &I : BB)
+        ValueNumbers[&I] = NumValues++;
+    }
+
+    llvm::hash_code H =
+        llvm::hash_value(F->getLoweredFunctionType().getPointer());
+    for (auto &BB : *F) {
+      H = llvm::hash_combine(H, BB.getNumArguments());
+      for (SILArgument *Arg : BB.getArguments())
+        H = llvm::hash_combine(H, Arg->getType().getOpaqueValue());
+      for (auto &I : BB) {
+        H = llvm::hash_combine(H, unsigned(I.getKind()),
+                               I.getType().getOpaqueValue());
+        for (const Operand &Op : I.getAllOperands()) {
+          auto Iter = ValueNumbers.find(Op.get());
+          H = Iter == ValueNumbers.end()
+                  ? llvm::hash_combine(H, Op.get().getOpaqueValue())
+                  : llvm::hash_combine(H, Iter->second);
+        }
+        if (auto *TI = dyn_cast<TermInst>(&I))
+          for (const SILSuccessor &Succ : TI->getSuccessors())
+            H = llvm::hash_combine(H, BlockNumbers.lookup(Succ.getBB()));
+        if (auto *FRI = dyn_cast<FunctionRefInst>(&I)) {
+          // Recursive calls refer to the function itself.
+          SILFunction *Callee = FRI->getReferencedFunction();
+          H = llvm::hash_combine(H, Callee == F ? nullptr : Callee);
+        }
+        if (auto *IL = dyn_cast<IntegerLiteralInst>(&I))
+          H = llvm::hash_combine(H, llvm::hash_value(IL->getValue()));
+      }
+    }
+    return H;
+  }
+
+  /// Returns true if \p F may be merged with other functions.
+  static bool isCandidate(SILFunction *F) {
+    if (F->isExternalDeclaration() || F->isZombie())
+      return false;
+    // The names of the generic parameters of the function and the archetypes
+    // in its body are not canonical.
+    if (F->getGenericEnvironment())
+      return false;
+    return true;
+  }
+
+  /// Returns true if all references to \p F can be redirected to another
+  /// function, so that \p F can be deleted.
+  bool canBeReplaced(SILFunction *F) {
+    if (F->isPossiblyUsedExternally() || F->isKeepAsPublic() ||
+        F->isGlobalInit())
+      return false;
+    // ObjC functions are called through the runtime and are therefore alive
+    // even if not referenced inside SIL.
+    if (F->getRepresentation() == SILFunctionTypeRepresentation::ObjCMethod)
+      return false;
+    // A function without any references in SIL may still be used in a way
+    // which is not visible here. Leave it to dead function elimination.
+    unsigned RefCount = F->getRefCount();
+    if (RefCount == 0)
+      return false;
+    // References from vtables, witness tables and global variables are not
+    // redirected.
+    auto Iter = FuncRefs.find(F);
+    unsigned NumFuncRefs = Iter == FuncRefs.end() ? 0 : Iter->second.size();
+    return RefCount == NumFuncRefs;
+  }
+
+  /// Returns true if \p F1 and \p F2 are identical and have the same
+  /// attributes.
+  bool areIdentical(SILFunction *F1, SILFunction *F2) {
+    if (F1->getLoweredFunctionType() != F2->getLoweredFunctionType() ||
+        F1->isTransparent() != F2->isTransparent() ||
+        F1->isFragile() != F2->isFragile() ||
+        F1->isThunk() != F2->isThunk() ||
+        F1->getInlineStrategy() != F2->getInlineStrategy() ||
+        F1->getEffectsKind() != F2->getEffectsKind() ||
+        !F1->getSemanticsAttrs().equals(F2->getSemanticsAttrs()) ||
+        !F1->getSpecializeAttrs().empty() ||
+        !F2->getSpecializeAttrs().empty())
+      return false;
+    return FunctionComparator(F1, F2).compare();
+  }
+
+  /// Replaces all references to \p Dup with references to \p Orig and deletes
+  /// \p Dup.
+  void replaceFunction(SILFunction *Dup, SILFunction *Orig) {
+    DEBUG(llvm::dbgs() << "  merge " << Dup->getName() << " into "
+                       << Orig->getName() << "\n");
+    auto DupRefs = std::move(FuncRefs[Dup]);
+    FuncRefs.erase(Dup);
+    for (FunctionRefInst *FRI : DupRefs) {
+      SILBuilderWithScope B(FRI);
+      auto *NewFRI = B.createFunctionRef(FRI->getLoc(), Orig);
+      FRI->replaceAllUsesWith(NewFRI);
+      SILFunction *Caller = FRI->getFunction();
+      FRI->eraseFromParent();
+      FuncRefs[Orig].push_back(NewFRI);
+      invalidateAnalysis(Caller,
+                         SILAnalysis::InvalidationKind::CallsAndInstructions);
+    }
+
+    // Forget the references from the body of the deleted function.
+    for (auto &BB : *Dup) {
+      for (auto &I : BB) {
+        auto *FRI = dyn_cast<FunctionRefInst>(&I);
+        if (!FRI)
+          continue;
+        auto &Refs = FuncRefs[FRI->getReferencedFunction()];
+        Refs.erase(std::remove(Refs.begin(), Refs.end(), FRI), Refs.end());
+      }
+      NumInstsMerged += BB.size();
+    }
+    ++NumFunctionsMerged;
+
+    invalidateAnalysisForDeadFunction(Dup,
+                                      SILAnalysis::InvalidationKind::Everything);
+    Dup->dropAllReferences();
+    getModule()->eraseFunction(Dup);
+  }
+
+  void run() override {
+    SILModule *M = getModule();
+
+    // Group the candidates by their hash, in module order.
+    llvm::MapVector<size_t, SmallVector<SILFunction *, 2>> Groups;
+    for (SILFunction &F : *M) {
+      for (auto &BB : F)
+        for (auto &I : BB)
+          if (auto *FRI = dyn_cast<FunctionRefInst>(&I))
+            FuncRefs[FRI->getReferencedFunction()].push_back(FRI);
+
+      if (isCandidate(&F))
+        Groups[hashFunction(&F)].push_back(&F);
+    }
+
+    for (auto &Group : Groups) {
+      auto &Funcs = Group.second;
+      if (Funcs.size() < 2)
+        continue;
+
+      // Keep the functions which can't be deleted and merge the other ones
+      // into an identical function.
+      std::stable_partition(Funcs.begin(), Funcs.end(),
+                            [this](SILFunction *F) {
+                              return !canBeReplaced(F);
+                            });
+      SmallVector<SILFunction *, 2> Kept;
+      for (SILFunction *F : Funcs) {
+        SILFunction *Orig = nullptr;
+        if (canBeReplaced(F)) {
+          for (SILFunction *K : Kept) {
+            if (areIdentical(K, F)) {
+              Orig = K;
+              break;
+            }
+          }
+        }
+        if (Orig)
+          replaceFunction(F, Orig);
+        else
+          Kept.push_back(F);
+      }
+    }
+
+    FuncRefs.clear();
+  }
+
+  StringRef getName() override { return "Function Merging"; }
+};
+
+} // end anonymous namespace
+
+SILTransform *swift::createFunctionMerging() {
+  return new FunctionMerging();
+}
@@ -20,11 +20,19 @@
 #include "swift/SIL/SILInstruction.h"
 #include "swift/SIL/SILFunction.h"
 #include "swift/SIL/SILModule.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Debug.h"
 #include "swift/SILOptimizer/Utils/Generics.h"
 
 using namespace swift;
 
+STATISTIC(NumLookups,
+          "Number of specializations looked up in imported modules");
+STATISTIC(NumLookupsFound,
+          "Number of specializations found in imported modules");
+STATISTIC(NumLookupsSkipped,
+          "Number of lookups skipped for specializations of local functions");
+
 namespace {
 
 
@@ -127,14 +135,24 @@ bool UsePrespecialized::replaceByPrespecialized(SILFunction &F) {
     }
 
     if (!PrevF || !NewF) {
+      // Specializations are only exported by the module which defines the
+      // generic function, so don't search the imported modules for
+      // specializations of this module's own functions.
+      if (!ReferencedF->isAvailableExternally()) {
+        ++NumLookupsSkipped;
+        continue;
+      }
+
       // Check for the existence of this function in another module without
       // loading the function body.
+      ++NumLookups;
       PrevF = lookupPrespecializedSymbol(M, ClonedName);
       DEBUG(llvm::dbgs()
             << "Checked if there is a specialization in a different module: "
             << PrevF << "\n");
       if (!PrevF)
         continue;
+      ++NumLookupsFound;
       assert(PrevF->isExternalDeclaration() &&
              "Prespecialized function should be an external declaration");
       NewF = PrevF;
@@ -21,6 +21,7 @@
 #include "swift/SILOptimizer/PassManager/Transforms.h"
 #include "swift/SILOptimizer/Utils/SILInliner.h"
 #include "swift/SILOptimizer/Utils/SILSSAUpdater.h"
+#include "llvm/Support/CommandLine.h"
 
 using namespace swift;
 using namespace swift::PatternMatch;
@@ -30,6 +31,11 @@ using llvm::MapVector;
 
 static const uint64_t SILLoopUnrollThreshold = 250;
 
+static llvm::cl::opt<unsigned> SILLoopUnrollRuntimeFactor(
+    "sil-loop-unroll-runtime-factor", llvm::cl::init(4),
+    llvm::cl::desc("The number of copies of the body in loops unrolled with a "
+                   "runtime trip count (0 disables partial unrolling)"));
+
 namespace {
 
 /// Clone the basic blocks in a loop.
@@ -415,6 +421,235 @@ static bool tryToUnrollLoop(SILLoop *Loop) {
   return true;
 }
 
+// =============================================================================
+//                      Unrolling with a runtime trip count
+// =============================================================================
+
+namespace {
+
+/// A loop whose only exit is an induction variable, which is incremented by one
+/// and compared against a loop invariant end value:
+///
+///   header(%iv):
+///     ...
+///   exiting:
+///     %inc = builtin "sadd_with_overflow"(%iv, 1)
+///     %next = tuple_extract %inc, 0
+///     %cmp = builtin "cmp_eq"(%next, %end)
+///     cond_br %cmp, exit, continue
+///
+/// or equivalently with "cmp_ne" and the exit as the false destination. In
+/// both cases the loop is left exactly when %next reaches %end.
+struct RuntimeTripCountLoop {
+  SILBasicBlock *ExitingBlock = nullptr;
+  bool ExitIsTrueDest = false;
+  SILArgument *IV = nullptr;
+  SILValue Next;
+  SILValue End;
+};
+
+} // end anonymous namespace
+
+/// Match the exit condition of a loop which can be unrolled with a runtime
+/// trip count.
+static Optional<RuntimeTripCountLoop>
+matchRuntimeTripCountLoop(SILLoop *Loop, SILBasicBlock *Header,
+                          SILBasicBlock *Latch) {
+  SmallVector<SILBasicBlock *, 4> ExitingBlocks;
+  Loop->getExitingBlocks(ExitingBlocks);
+  if (ExitingBlocks.size() != 1)
+    return None;
+
+  RuntimeTripCountLoop Info;
+  Info.ExitingBlock = ExitingBlocks[0];
+  auto *CondBr = dyn_cast<CondBranchInst>(Info.ExitingBlock->getTerminator());
+  if (!CondBr)
+    return None;
+  Info.ExitIsTrueDest = !Loop->contains(CondBr->getTrueBB());
+  if (Info.ExitIsTrueDest == !Loop->contains(CondBr->getFalseBB()))
+    return None;
+
+  // The unrolled copies must end in a branch to the next copy.
+  if (Latch != Info.ExitingBlock && !isa<BranchInst>(Latch->getTerminator()))
+    return None;
+
+  // The loop must be left when the induction variable reaches the end value.
+  // A cmp_eq whose true edge stays in the loop iterates while it *is* equal,
+  // which is not a counted loop.
+  auto ExitPredicate = Info.ExitIsTrueDest ? BuiltinValueKind::ICMP_EQ
+                                           : BuiltinValueKind::ICMP_NE;
+  if (!match(CondBr->getCondition(),
+             m_BuiltinInst(ExitPredicate, m_SILValue(Info.Next),
+                           m_SILValue(Info.End))))
+    return None;
+  if (!match(Info.Next,
+             m_TupleExtractInst(m_ApplyInst(BuiltinValueKind::SAddOver,
+                                            m_SILArgument(Info.IV), m_One()),
+                                0)))
+    return None;
+
+  if (Info.IV->getParent() != Header ||
+      Info.IV->getIncomingValue(Latch) != Info.Next)
+    return None;
+
+  // The end value must be available in the preheader.
+  auto *EndBB = Info.End->getParentBlock();
+  if (!EndBB || Loop->contains(EndBB))
+    return None;
+  if (!Info.End->getType().is<BuiltinIntegerType>())
+    return None;
+
+  return Info;
+}
+
+/// Check whether a loop is worth unrolling with a runtime trip count.
+///
+/// We only unroll small loops which neither call functions nor touch reference
+/// counts. These are the loops which LLVM can vectorize and for which removing
+/// the per-iteration exit checks pays off.
+static bool canAndShouldPartiallyUnrollLoop(SILLoop *Loop, unsigned Factor) {
+  assert(Loop->getSubLoops().empty() && "Expect innermost loops");
+  uint64_t Cost = 0;
+  for (auto *BB : Loop->getBlocks()) {
+    for (auto &Inst : *BB) {
+      if (!Loop->canDuplicate(&Inst))
+        return false;
+      if (FullApplySite::isa(&Inst) || isa<RefCountingInst>(&Inst) ||
+          Inst.mayRelease())
+        return false;
+      if (instructionInlineCost(Inst) != InlineCost::Free)
+        ++Cost;
+      if (Cost * Factor > SILLoopUnrollThreshold)
+        return false;
+    }
+  }
+  return true;
+}
+
+/// Replace the exit check of an unrolled copy of the loop body with a branch
+/// to the next block in the loop.
+static void removeExitCheck(SILBasicBlock *ExitingBlock, bool ExitIsTrueDest) {
+  auto *CondBr = cast<CondBranchInst>(ExitingBlock->getTerminator());
+  SILBuilder B(CondBr);
+  if (ExitIsTrueDest)
+    B.createBranch(CondBr->getLoc(), CondBr->getFalseBB(),
+                   CondBr->getFalseArgs());
+  else
+    B.createBranch(CondBr->getLoc(), CondBr->getTrueBB(),
+                   CondBr->getTrueArgs());
+  CondBr->eraseFromParent();
+}
+
+/// Partially unroll a loop whose trip count is only known at runtime.
+///
+/// The loop is versioned: an unrolled loop executes Factor copies of the body
+/// without the intermediate exit checks as long as more than Factor iterations
+/// remain. The original loop executes the remaining iterations.
+///
+///   preheader:
+///     (%limit, %overflow) = ssub_with_overflow %end, Factor
+///     cond_br %overflow, header(%start), guard
+///   guard:
+///     cond_br (cmp_slt %start, %limit), header_1(%start), header(%start)
+///   header_1:
+///     ...                     // Factor copies of the body
+///     cond_br (cmp_slt %next_Factor, %limit), header_1(..), header(..)
+///   header:
+///     ...                     // the original loop
+static bool tryToPartiallyUnrollLoop(SILLoop *Loop, unsigned Factor) {
+  assert(Loop->getSubLoops().empty() && "Expecting innermost loops");
+  if (Factor < 2)
+    return false;
+
+  auto *Preheader = Loop->getLoopPreheader();
+  if (!Preheader)
+    return false;
+  auto *Latch = Loop->getLoopLatch();
+  if (!Latch)
+    return false;
+  auto *Header = Loop->getHeader();
+
+  // Loops with a constant trip count are fully unrolled by the high-level loop
+  // unroller if they are small enough.
+  if (getMaxLoopTripCount(Loop, Preheader, Header, Latch))
+    return false;
+
+  auto Info = matchRuntimeTripCountLoop(Loop, Header, Latch);
+  if (!Info)
+    return false;
+
+  auto *PreheaderBr = dyn_cast<BranchInst>(Preheader->getTerminator());
+  if (!PreheaderBr)
+    return false;
+
+  if (!canAndShouldPartiallyUnrollLoop(Loop, Factor))
+    return false;
+
+  DEBUG(llvm::dbgs() << "Unrolling loop in " << Header->getParent()->getName()
+                     << " by " << Factor << " " << *Loop << "\n");
+
+  // Clone the body. The copies are self-contained loops at first.
+  SmallVector<SILBasicBlock *, 8> Headers;
+  SmallVector<SILBasicBlock *, 8> Latches;
+  SILValue LastNext;
+  for (unsigned Cnt = 0; Cnt < Factor; ++Cnt) {
+    LoopCloner Cloner(Loop);
+    Cloner.cloneLoop();
+    Headers.push_back(Cloner.getBBMap()[Header]);
+    Latches.push_back(Cloner.getBBMap()[Latch]);
+    removeExitCheck(Cloner.getBBMap()[Info->ExitingBlock],
+                    Info->ExitIsTrueDest);
+    if (Cnt == Factor - 1)
+      LastNext = Cloner.getInstMap()[cast<SILInstruction>(Info->Next)];
+  }
+
+  // Compute the limit in the preheader and enter the unrolled loop if more
+  // than Factor iterations remain.
+  auto Loc = PreheaderBr->getLoc();
+  SILType IntTy = Info->End->getType();
+  SILType Int1Ty =
+      SILType::getBuiltinIntegerType(1, Header->getModule().getASTContext());
+  SmallVector<SILValue, 4> StartArgs(PreheaderBr->getArgs().begin(),
+                                     PreheaderBr->getArgs().end());
+  SILValue Start = Info->IV->getIncomingValue(Preheader);
+
+  SILBuilder B(PreheaderBr);
+  SILValue SubArgs[] = {Info->End, B.createIntegerLiteral(Loc, IntTy, Factor),
+                        B.createIntegerLiteral(Loc, Int1Ty, -1)};
+  auto *Sub =
+      B.createBuiltinBinaryFunctionWithOverflow(Loc, "ssub_with_overflow",
+                                                SubArgs);
+  SILValue Limit = B.createTupleExtract(Loc, Sub, 0);
+  SILValue Overflow = B.createTupleExtract(Loc, Sub, 1);
+  auto *GuardBB = Header->getParent()->createBasicBlock(Preheader);
+  B.createCondBranch(Loc, Overflow, Header, StartArgs, GuardBB, {});
+  PreheaderBr->eraseFromParent();
+
+  B.setInsertionPoint(GuardBB);
+  auto *EnterCmp = B.createBuiltinBinaryFunction(Loc, "cmp_slt", IntTy, Int1Ty,
+                                                 {Start, Limit});
+  B.createCondBranch(Loc, EnterCmp, Headers[0], StartArgs, Header, StartArgs);
+
+  // Chain the copies and branch back to the first copy while more than Factor
+  // iterations remain.
+  for (unsigned Cnt = 0; Cnt < Factor; ++Cnt) {
+    auto *Br = cast<BranchInst>(Latches[Cnt]->getTerminator());
+    assert(Br->getDestBB() == Headers[Cnt] && "latch must branch to header");
+    SmallVector<SILValue, 4> Args(Br->getArgs().begin(), Br->getArgs().end());
+    B.setInsertionPoint(Br);
+    if (Cnt + 1 < Factor) {
+      B.createBranch(Br->getLoc(), Headers[Cnt + 1], Args);
+    } else {
+      auto *ContinueCmp = B.createBuiltinBinaryFunction(
+          Br->getLoc(), "cmp_slt", IntTy, Int1Ty, {LastNext, Limit});
+      B.createCondBranch(Br->getLoc(), ContinueCmp, Headers[0], Args, Header,
+                         Args);
+    }
+    Br->eraseFromParent();
+  }
+  return true;
+}
+
 // =============================================================================
 //                                 Driver
 // =============================================================================
@@ -422,8 +657,16 @@ static bool tryToUnrollLoop(SILLoop *Loop) {
 namespace {
 
 class LoopUnrolling : public SILFunctionTransform {
+  /// If true, unroll loops with a runtime trip count by a constant factor
+  /// instead of fully unrolling loops with a constant trip count.
+  bool Partial;
 
-  StringRef getName() override { return "SIL Loop Unrolling"; }
+public:
+  LoopUnrolling(bool Partial) : Partial(Partial) {}
+
+  StringRef getName() override {
+    return Partial ? "SIL Partial Loop Unrolling" : "SIL Loop Unrolling";
+  }
 
   void run() override {
     bool Changed = false;
@@ -447,8 +690,12 @@ class LoopUnrolling : public SILFunctionTransform {
     }
 
     // Try to unroll innermost loops.
-    for (auto *Loop : InnermostLoops)
-      Changed |= tryToUnrollLoop(Loop);
+    for (auto *Loop : InnermostLoops) {
+      if (Partial)
+        Changed |= tryToPartiallyUnrollLoop(Loop, SILLoopUnrollRuntimeFactor);
+      else
+        Changed |= tryToUnrollLoop(Loop);
+    }
 
     if (Changed) {
       invalidateAnalysis(SILAnalysis::InvalidationKind::FunctionBody);
@@ -459,5 +706,9 @@ class LoopUnrolling : public SILFunctionTransform {
 } // end anonymous namespace.
 
 SILTransform *swift::createLoopUnroll() {
-  return new LoopUnrolling();
+  return new LoopUnrolling(/*Partial*/ false);
+}
+
+SILTransform *swift::createPartialLoopUnroll() {
+  return new LoopUnrolling(/*Partial*/ true);
 }
@@ -91,6 +91,16 @@ llvm::cl::opt<bool> SILVerifyWithoutInvalidation(
     "sil-verify-without-invalidation", llvm::cl::init(false),
     llvm::cl::desc("Verify after passes even if the pass has not invalidated"));
 
+llvm::cl::opt<unsigned> SILVerifySampleRate(
+    "sil-verify-sample-rate", llvm::cl::init(1),
+    llvm::cl::desc("With -sil-verify-all, verify only about one in <N> "
+                   "changed functions after each pass"));
+
+llvm::cl::opt<bool> SILVerifyFullModule(
+    "sil-verify-full-module", llvm::cl::init(false),
+    llvm::cl::desc("With -sil-verify-all, verify the whole module after each "
+                   "module pass instead of only the changed functions"));
+
 llvm::cl::opt<bool> SILDisableSkippingPasses(
     "sil-disable-skipping-passes", llvm::cl::init(false),
     llvm::cl::desc("Do not skip passes even if nothing was changed"));
@@ -343,7 +353,8 @@ void SILPassManager::runPassOnFunction(SILFunctionTransform *SFT,
     completedPasses.set((size_t)SFT->getPassKind());
 
   if (getOptions().VerifyAll &&
-      (CurrentPassHasInvalidated || SILVerifyWithoutInvalidation)) {
+      (CurrentPassHasInvalidated || SILVerifyWithoutInvalidation) &&
+      shouldVerify(F)) {
     F->verify();
     verifyAnalyses(F);
   }
@@ -427,6 +438,15 @@ void SILPassManager::runModulePass(SILModuleTransform *SMT) {
   SMT->injectModule(Mod);
 
   CurrentPassHasInvalidated = false;
+  CurrentPassHasInvalidatedModule = false;
+  ChangedFunctions.clear();
+
+  // Functions which are created by the pass are verified even if the pass
+  // does not notify the analyses. They are recognized by their creation
+  // index, because a new function may reuse the address of a function which
+  // the pass deleted.
+  unsigned FirstNewFunctionIndex = Mod->getNextFunctionCreationIndex();
+  bool VerifyChangedFunctions = Options.VerifyAll && !SILVerifyFullModule;
 
   if (SILPrintPassName)
     llvm::dbgs() << "#" << NumPassesRun << " Stage: " << StageName
@@ -461,11 +481,51 @@ void SILPassManager::runModulePass(SILModuleTransform *SMT) {
     printModule(Mod, Options.EmitVerboseSIL);
   }
 
-  if (Options.VerifyAll &&
-      (CurrentPassHasInvalidated || !SILVerifyWithoutInvalidation)) {
+  if (!Options.VerifyAll)
+    return;
+
+  if (!VerifyChangedFunctions) {
+    if (CurrentPassHasInvalidated || !SILVerifyWithoutInvalidation) {
+      Mod->verify();
+      verifyAnalyses();
+    }
+    return;
+  }
+
+  // If the pass didn't tell which functions it changed, we have to verify
+  // the whole module.
+  if (CurrentPassHasInvalidatedModule || SILVerifyWithoutInvalidation) {
     Mod->verify();
     verifyAnalyses();
+    return;
+  }
+
+  // Otherwise only verify the functions which were changed or added by the
+  // pass. The whole module is still verified at the end of the pipeline.
+  for (SILFunction &F : *Mod) {
+    if (F.isExternalDeclaration())
+      continue;
+    if ((ChangedFunctions.count(&F) ||
+         F.getCreationIndex() >= FirstNewFunctionIndex) &&
+        shouldVerify(&F)) {
+      F.verify();
+      verifyAnalyses(&F);
+    }
   }
+  ChangedFunctions.clear();
+}
+
+bool SILPassManager::shouldVerify(SILFunction *F) {
+  if (SILVerifySampleRate <= 1)
+    return true;
+
+  // Verify every N-th candidate. The count runs on across passes, so a
+  // function which is skipped after one pass is likely to be verified after
+  // another one, but the choice is the same in every compiler run.
+  bool Verify = NumVerificationCandidates++ % SILVerifySampleRate == 0;
+  DEBUG(llvm::dbgs() << (Verify ? "Verify " : "Skip verification of ")
+                     << F->getName() << "\n");
+  return Verify;
 }
 
 void SILPassManager::runOneIteration() {
@@ -578,7 +638,7 @@ void SILPassManager::addFunctionToWorklist(SILFunction *F,
     // add support for verifying that all specialized functions are added via
     // this function to the pass manager to ensure that we perform this
     // verification.
-    if (getOptions().VerifyAll) {
+    if (getOptions().VerifyAll && shouldVerify(F)) {
       F->verify();
     }
 
@@ -404,6 +404,10 @@ void swift::runSILOptimizationPasses(SILModule &Module) {
   PM.addRedundantOverflowCheckRemoval();
   PM.addMergeCondFails();
 
+  // Unroll small loops with a runtime trip count, now that bounds checks and
+  // ARC operations are hoisted out of them.
+  PM.addPartialLoopUnroll();
+
   // Remove dead code.
   PM.addDCE();
   PM.addSimplifyCFG();
@@ -415,6 +419,10 @@ void swift::runSILOptimizationPasses(SILModule &Module) {
   PM.runOneIteration();
 
   PM.resetAndRemoveTransformations();
+
+  // Merge functions which became identical after all the optimizations, e.g.
+  // specializations and thunks which are only different by name.
+  PM.addFunctionMerging();
   
   // Has only an effect if the -gsil option is specified.
   PM.addSILDebugInfoGenerator();
@@ -85,6 +85,13 @@ STATISTIC(NumPartialDeadStores, "Number of partial dead stores removed");
 static llvm::cl::opt<unsigned>
 MaxPartialStoreCount("max-partial-store-count", llvm::cl::init(1), llvm::cl::Hidden);
 
+/// Skip the data flow across basic blocks. This is used for testing the
+/// processing of large functions.
+static llvm::cl::opt<bool>
+DSELocalOnly("dse-local-only", llvm::cl::init(false), llvm::cl::Hidden,
+   llvm::cl::desc("Only remove stores which are dead within their "
+                  "basic block"));
+
 /// ComputeMaxStoreSet - If we ignore all reads, what is the max store set that
 /// can reach a particular point in a basic block. This helps in generating
 /// the genset and killset. i.e. if there is no upward visible store that can
@@ -159,8 +166,9 @@ namespace {
 /// # of BBs x(times) # of locations.
 ///
 /// we could run DSE on functions with 256 basic blocks and 256 locations,
-/// which is a large function.  
-constexpr unsigned MaxLSLocationBBMultiplicationNone = 256*256;
+/// which is a large function. Larger functions are only optimized within
+/// basic blocks.
+constexpr unsigned MaxLSLocationBBMultiplicationLocal = 256*256;
 
 /// we could run optimistic DSE on functions with less than 64 basic blocks
 /// and 64 locations which is a sizable function.
@@ -265,6 +273,17 @@ public:
 
   /// Set the store bit for stack slot deallocated in this basic block. 
   void initStoreSetAtEndOfBlock(DSEContext &Ctx);
+
+  /// Free the bit vectors once they are no longer needed.
+  void releaseLocationSets() {
+    BBWriteSetOut = llvm::SmallBitVector();
+    BBWriteSetMid = llvm::SmallBitVector();
+    BBWriteSetIn = llvm::SmallBitVector();
+    BBGenSet = llvm::SmallBitVector();
+    BBKillSet = llvm::SmallBitVector();
+    BBMaxStoreSet = llvm::SmallBitVector();
+    BBDeallocateLocation = llvm::SmallBitVector();
+  }
 };
 
 } // end anonymous namespace
@@ -300,7 +319,8 @@ class DSEContext {
 enum class ProcessKind {
   ProcessOptimistic = 0,
   ProcessPessimistic = 1,
-  ProcessNone = 2,
+  ProcessLocal = 2,
+  ProcessNone = 3,
 }; 
 
 private:
@@ -350,6 +370,24 @@ private:
   /// Keeps a map between the accessed SILValue and the location.
   LSLocationBaseMap BaseToLocIndex;
 
+  /// The indices of the locations in the LocationVault for each base.
+  llvm::DenseMap<SILValue, llvm::SmallVector<unsigned, 4>> BaseToLocations;
+
+  /// The indices of the stack locations deallocated in each basic block.
+  llvm::DenseMap<SILBasicBlock *, llvm::SmallVector<unsigned, 4>>
+      BBToDeallocatedLocations;
+
+  /// Returns the indices of the locations with the base \p Base.
+  ArrayRef<unsigned> getLocationsWithBase(SILValue Base) {
+    auto Iter = BaseToLocations.find(Base);
+    if (Iter == BaseToLocations.end())
+      return {};
+    return Iter->second;
+  }
+
+  /// Fill BaseToLocations and BBToDeallocatedLocations.
+  void indexLocations();
+
   /// Return the BlockState for the basic block this basic block belongs to.
   BlockState *getBlockState(SILBasicBlock *B) { return BBToLocState[B]; }
 
@@ -433,12 +471,24 @@ public:
   /// Entry point for dead store elimination.
   bool run();
 
+  /// Delete the dead stores and create the stores which are alive due to
+  /// partial dead stores. Returns true if the function changed.
+  bool removeDeadStores();
+
   /// Run the iterative DF to converge the BBWriteSetIn.
   void runIterativeDSE();
 
   /// Returns the location vault of the current function.
   std::vector<LSLocation> &getLocationVault() { return LocationVault; }
 
+  /// Returns the indices of the stack locations deallocated in \p BB.
+  ArrayRef<unsigned> getDeallocatedLocations(SILBasicBlock *BB) {
+    auto Iter = BBToDeallocatedLocations.find(BB);
+    if (Iter == BBToDeallocatedLocations.end())
+      return {};
+    return Iter->second;
+  }
+
   /// Use a set of ad hoc rules to tell whether we should run a pessimistic
   /// one iteration data flow on the function.
   ProcessKind getProcessFunctionKind(unsigned StoreCount);
@@ -447,6 +497,9 @@ public:
   /// changes.
   void processBasicBlockForDSE(SILBasicBlock *BB, bool Optimistic);
 
+  /// Perform the dead store elimination within each basic block only.
+  void processBasicBlocksForLocalDSE();
+
   /// Compute the genset and killset for the current basic block.
   void processBasicBlockForGenKillSet(SILBasicBlock *BB);
 
@@ -536,9 +589,11 @@ DSEContext::ProcessKind DSEContext::getProcessFunctionKind(unsigned StoreCount)
     HandledBBs.insert(B);
   }
 
-  // Data flow may take too long to run.
-  if (BBCount * LocationCount > MaxLSLocationBBMultiplicationNone)
-    return ProcessKind::ProcessNone;
+  // Data flow may take too long to run. Only remove stores which are dead
+  // within their basic block, which is linear in the size of the function.
+  if (DSELocalOnly ||
+      BBCount * LocationCount > MaxLSLocationBBMultiplicationLocal)
+    return ProcessKind::ProcessLocal;
 
   // This function's data flow would converge in 1 iteration.
   if (RunOneIteration)
@@ -610,6 +665,25 @@ bool DSEContext::processBasicBlockWithGenKillSet(SILBasicBlock *BB) {
   return S->updateBBWriteSetIn(S->BBWriteSetMid);
 }
 
+void DSEContext::processBasicBlocksForLocalDSE() {
+  unsigned LocationNum = LocationVault.size();
+  for (auto &B : *F) {
+    auto *S = new (BPA.Allocate()) BlockState(&B, LocationNum, false);
+    BBToLocState[&B] = S;
+    S->initStoreSetAtEndOfBlock(*this);
+
+    // Nothing is known to be overwritten at the end of the basic block, except
+    // for the stack slots which are deallocated in it.
+    S->BBWriteSetMid = S->BBDeallocateLocation;
+    for (auto I = B.rbegin(), E = B.rend(); I != E; ++I) {
+      processInstruction(&(*I), DSEKind::PerformDSE);
+    }
+
+    // The bit vectors are only needed while the basic block is processed.
+    S->releaseLocationSets();
+  }
+}
+
 void DSEContext::processBasicBlockForDSE(SILBasicBlock *BB, bool Optimistic) {
   // If we know this is not a one iteration function which means its
   // its BBWriteSetIn and BBWriteSetOut have been computed and converged, 
@@ -642,18 +716,21 @@ void DSEContext::processBasicBlockForDSE(SILBasicBlock *BB, bool Optimistic) {
 }
 
 void BlockState::initStoreSetAtEndOfBlock(DSEContext &Ctx) {
-  std::vector<LSLocation> &LocationVault = Ctx.getLocationVault();
   // We set the store bit at the end of the basic block in which a stack
   // allocated location is deallocated.
-  for (unsigned i = 0; i < LocationVault.size(); ++i) {
-    // Turn on the store bit at the block which the stack slot is deallocated.
-    if (auto *ASI = dyn_cast<AllocStackInst>(LocationVault[i].getBase())) {
-      for (auto X : findDeallocStackInst(ASI)) {
-        SILBasicBlock *DSIBB = X->getParent();
-        if (DSIBB != BB)
-          continue;
-        startTrackingLocation(BBDeallocateLocation, i);
-      }
+  for (unsigned i : Ctx.getDeallocatedLocations(BB))
+    startTrackingLocation(BBDeallocateLocation, i);
+}
+
+void DSEContext::indexLocations() {
+  for (unsigned i = 0, e = LocationVault.size(); i != e; ++i) {
+    SILValue Base = LocationVault[i].getBase();
+    BaseToLocations[Base].push_back(i);
+    // Remember the blocks in which the stack slot is deallocated, so that we
+    // don't have to look at all locations for every basic block.
+    if (auto *ASI = dyn_cast<AllocStackInst>(Base)) {
+      for (auto X : findDeallocStackInst(ASI))
+        BBToDeallocatedLocations[X->getParent()].push_back(i);
     }
   }
 }
@@ -693,20 +770,14 @@ void DSEContext::mergeSuccessorLiveIns(SILBasicBlock *BB) {
 }
 
 void DSEContext::invalidateBaseForGenKillSet(SILValue B, BlockState *S) {
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (LocationVault[i].getBase() != B)
-      continue;
+  for (unsigned i : getLocationsWithBase(B)) {
     S->startTrackingLocation(S->BBKillSet, i);
     S->stopTrackingLocation(S->BBGenSet, i);
   }
 }
 
 void DSEContext::invalidateBaseForDSE(SILValue B, BlockState *S) {
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->BBWriteSetMid.test(i))
-      continue;
-    if (LocationVault[i].getBase() != B)
-      continue;
+  for (unsigned i : getLocationsWithBase(B)) {
     S->stopTrackingLocation(S->BBWriteSetMid, i);
   }
 }
@@ -734,9 +805,8 @@ void DSEContext::processReadForDSE(BlockState *S, unsigned bit) {
   // Remove any may/must-aliasing stores to the LSLocation, as they can't be
   // used to kill any upward visible stores due to the interfering load.
   LSLocation &R = LocationVault[bit];
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->isTrackingLocation(S->BBWriteSetMid, i))
-      continue;
+  for (int i = S->BBWriteSetMid.find_first(); i != -1;
+       i = S->BBWriteSetMid.find_next(i)) {
     LSLocation &L = LocationVault[i];
     if (!L.isMayAliasLSLocation(R, AA))
       continue;
@@ -751,9 +821,8 @@ void DSEContext::processReadForGenKillSet(BlockState *S, unsigned bit) {
   // Even though, LSLocations are canonicalized, we still need to consult
   // alias analysis to determine whether 2 LSLocations are disjointed.
   LSLocation &R = LocationVault[bit];
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->BBMaxStoreSet.test(i))
-      continue;
+  for (int i = S->BBMaxStoreSet.find_first(); i != -1;
+       i = S->BBMaxStoreSet.find_next(i)) {
     // Do nothing if the read location NoAlias with the current location.
     LSLocation &L = LocationVault[i];
     if (!L.isMayAliasLSLocation(R, AA))
@@ -824,9 +893,8 @@ bool DSEContext::processWriteForDSE(BlockState *S, unsigned bit) {
   // If a tracked store must aliases with this store, then this store is dead.
   bool StoreDead = false;
   LSLocation &R = LocationVault[bit];
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->isTrackingLocation(S->BBWriteSetMid, i))
-      continue;
+  for (int i = S->BBWriteSetMid.find_first(); i != -1;
+       i = S->BBWriteSetMid.find_next(i)) {
     // If 2 locations may alias, we can still keep both stores.
     LSLocation &L = LocationVault[i];
     if (!L.isMustAliasLSLocation(R, AA))
@@ -985,9 +1053,8 @@ void DSEContext::processStoreInst(SILInstruction *I, DSEKind Kind) {
 void DSEContext::processDebugValueAddrInstForGenKillSet(SILInstruction *I) {
   BlockState *S = getBlockState(I);
   SILValue Mem = cast<DebugValueAddrInst>(I)->getOperand();
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->BBMaxStoreSet.test(i))
-      continue;
+  for (int i = S->BBMaxStoreSet.find_first(); i != -1;
+       i = S->BBMaxStoreSet.find_next(i)) {
     if (AA->isNoAlias(Mem, LocationVault[i].getBase()))
       continue;
     S->stopTrackingLocation(S->BBGenSet, i);
@@ -998,9 +1065,8 @@ void DSEContext::processDebugValueAddrInstForGenKillSet(SILInstruction *I) {
 void DSEContext::processDebugValueAddrInstForDSE(SILInstruction *I) {
   BlockState *S = getBlockState(I);
   SILValue Mem = cast<DebugValueAddrInst>(I)->getOperand();
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->isTrackingLocation(S->BBWriteSetMid, i))
-      continue;
+  for (int i = S->BBWriteSetMid.find_first(); i != -1;
+       i = S->BBWriteSetMid.find_next(i)) {
     if (AA->isNoAlias(Mem, LocationVault[i].getBase()))
       continue;
     S->stopTrackingLocation(S->BBWriteSetMid, i);
@@ -1025,9 +1091,8 @@ void DSEContext::processDebugValueAddrInst(SILInstruction *I, DSEKind Kind) {
 
 void DSEContext::processUnknownReadInstForGenKillSet(SILInstruction *I) {
   BlockState *S = getBlockState(I);
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->BBMaxStoreSet.test(i))
-      continue;
+  for (int i = S->BBMaxStoreSet.find_first(); i != -1;
+       i = S->BBMaxStoreSet.find_next(i)) {
     if (!AA->mayReadFromMemory(I, LocationVault[i].getBase()))
       continue;
     // Update the genset and kill set.
@@ -1038,9 +1103,8 @@ void DSEContext::processUnknownReadInstForGenKillSet(SILInstruction *I) {
 
 void DSEContext::processUnknownReadInstForDSE(SILInstruction *I) {
   BlockState *S = getBlockState(I);
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->isTrackingLocation(S->BBWriteSetMid, i))
-      continue;
+  for (int i = S->BBWriteSetMid.find_first(); i != -1;
+       i = S->BBWriteSetMid.find_next(i)) {
     if (!AA->mayReadFromMemory(I, LocationVault[i].getBase()))
       continue;
     S->stopTrackingLocation(S->BBWriteSetMid, i);
@@ -1140,6 +1204,13 @@ bool DSEContext::run() {
   if (Kind == ProcessKind::ProcessNone)
     return false;
 
+  indexLocations();
+
+  if (Kind == ProcessKind::ProcessLocal) {
+    processBasicBlocksForLocalDSE();
+    return removeDeadStores();
+  }
+
   // Do we run a pessimistic data flow ?
   bool Optimistic = Kind == ProcessKind::ProcessOptimistic ? true : false;
 
@@ -1183,7 +1254,11 @@ bool DSEContext::run() {
     processBasicBlockForDSE(B, Optimistic);
   }
 
-  // Finally, delete the dead stores and create the live stores.
+  return removeDeadStores();
+}
+
+bool DSEContext::removeDeadStores() {
+  // Delete the dead stores and create the live stores.
   bool Changed = false;
   for (SILBasicBlock &BB : *F) {
     // Create the stores that are alive due to partial dead stores.
@@ -20,9 +20,12 @@
 #include "swift/SIL/SILFunction.h"
 #include "swift/SIL/SILInstruction.h"
 #include "swift/SILOptimizer/Analysis/BasicCalleeAnalysis.h"
+#include "swift/SILOptimizer/Analysis/ColdBlockInfo.h"
+#include "swift/SILOptimizer/Analysis/DominanceAnalysis.h"
 #include "swift/SILOptimizer/Utils/Generics.h"
 #include "swift/SILOptimizer/Utils/Local.h"
 #include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 
 using namespace swift;
@@ -55,8 +58,23 @@ bool GenericSpecializer::specializeAppliesInFunction(SILFunction &F) {
   DeadInstructionSet DeadApplies;
   llvm::SmallSetVector<SILInstruction *, 8> Applies;
 
+  // With profile data only specialize call sites which were executed. The
+  // cold blocks are computed upfront because specialization may add blocks.
+  llvm::SmallPtrSet<SILBasicBlock *, 8> ColdBlockSet;
+  if (Optional<uint64_t> EntryCount = F.getEntryCount()) {
+    if (*EntryCount == 0)
+      return false;
+    ColdBlockInfo ColdBlocks(PM->getAnalysis<DominanceAnalysis>());
+    for (auto &BB : F)
+      if (ColdBlocks.isCold(&BB))
+        ColdBlockSet.insert(&BB);
+  }
+
   bool Changed = false;
   for (auto &BB : F) {
+    if (ColdBlockSet.count(&BB))
+      continue;
+
     // Collect the applies for this block in reverse order so that we
     // can pop them off the end of our vector and process them in
     // forward order.
@@ -18,6 +18,7 @@
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MathExtras.h"
 
 using namespace swift;
 
@@ -487,11 +488,41 @@ static void addWeightCorrection(FullApplySite FAS,
   }
 }
 
+/// Returns the additional loop weight of a call site in \p BB, based on how
+/// often the profile says \p BB was executed per entry of its function.
+static int getProfileWeight(SILBasicBlock *BB, DominanceInfo *DT) {
+  Optional<uint64_t> EntryCount = BB->getParent()->getEntryCount();
+  if (!EntryCount || *EntryCount == 0)
+    return 0;
+
+  // Counts are only attached to the first block of each profiled region. Use
+  // the count of the nearest dominating block which has one.
+  for (auto *Node = DT->getNode(BB); Node; Node = Node->getIDom()) {
+    Optional<uint64_t> Count = Node->getBlock()->getProfileCount();
+    if (!Count)
+      continue;
+    uint64_t ExecutionsPerEntry = *Count / *EntryCount;
+    if (ExecutionsPerEntry < 2)
+      return 0;
+    return std::min(int(llvm::Log2_64(ExecutionsPerEntry)),
+                    int(ShortestPathAnalysis::SingleLoopWeight));
+  }
+  return 0;
+}
+
 void SILPerformanceInliner::collectAppliesToInline(
     SILFunction *Caller, SmallVectorImpl<FullApplySite> &Applies) {
   DominanceInfo *DT = DA->get(Caller);
   SILLoopInfo *LI = LA->get(Caller);
 
+  // If the profile shows that the caller was never executed, the whole
+  // function is cold.
+  Optional<uint64_t> CallerEntryCount = Caller->getEntryCount();
+  if (CallerEntryCount && *CallerEntryCount == 0) {
+    visitColdBlocks(Applies, &Caller->front(), DT);
+    return;
+  }
+
   llvm::DenseMap<FullApplySite, int> WeightCorrections;
 
   // Compute the shortest-path analysis for the caller.
@@ -554,8 +585,10 @@ void SILPerformanceInliner::collectAppliesToInline(
         if (!BlockWeight.isValid())
           BlockWeight = SPA->getWeight(block, Weight(0, 0));
 
-        // The actual weight including a possible weight correction.
-        Weight W(BlockWeight, WeightCorrections.lookup(AI));
+        // The actual weight including a possible weight correction and the
+        // hotness of the block according to the profile.
+        Weight W(BlockWeight, WeightCorrections.lookup(AI) +
+                              getProfileWeight(block, DT));
 
         if (decideInWarmBlock(AI, W, constTracker, NumCallerBlocks))
           InitialCandidates.push_back(AI);
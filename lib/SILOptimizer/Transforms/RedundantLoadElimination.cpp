@@ -98,6 +98,12 @@ using namespace swift;
 
 STATISTIC(NumForwardedLoads, "Number of loads forwarded");
 
+/// Skip the data flow across basic blocks. This is used for testing the
+/// processing of large functions.
+static llvm::cl::opt<bool>
+RLELocalOnly("rle-local-only", llvm::cl::init(false), llvm::cl::Hidden,
+   llvm::cl::desc("Only forward loads within basic blocks"));
+
 /// Return the deallocate stack instructions corresponding to the given
 /// AllocStackInst.
 static SILInstruction *findAllocStackInst(SILInstruction *I) {
@@ -175,8 +181,9 @@ namespace {
 /// # of BBs x(times) # of locations.
 ///
 /// we could run RLE on functions with 128 basic blocks and 128 locations,
-/// which is a large function.  
-constexpr unsigned MaxLSLocationBBMultiplicationNone = 128*128;
+/// which is a large function. Larger functions are only optimized within
+/// basic blocks.
+constexpr unsigned MaxLSLocationBBMultiplicationLocal = 128*128;
 
 /// we could run optimistic RLE on functions with less than 64 basic blocks
 /// and 64 locations which is a sizable function.
@@ -317,6 +324,17 @@ public:
     BBKillSet.resize(LocationNum, false);
   }
 
+  /// Free the bit vectors and value maps once they are no longer needed.
+  void releaseLocationSets() {
+    ForwardSetIn = llvm::SmallBitVector();
+    ForwardSetOut = llvm::SmallBitVector();
+    ForwardSetMax = llvm::SmallBitVector();
+    BBGenSet = llvm::SmallBitVector();
+    BBKillSet = llvm::SmallBitVector();
+    ForwardValIn.clear();
+    ForwardValOut.clear();
+  }
+
   /// Initialize the AvailSetMax by intersecting this basic block's
   /// predecessors' AvailSetMax.
   void mergePredecessorsAvailSetMax(RLEContext &Ctx);
@@ -418,7 +436,8 @@ class RLEContext {
   enum class ProcessKind {
     ProcessMultipleIterations = 0,
     ProcessOneIteration = 1,
-    ProcessNone = 2,
+    ProcessLocal = 2,
+    ProcessNone = 3,
   }; 
 private:
   /// Function currently processing.
@@ -455,6 +474,9 @@ private:
   /// Keeps a map between the accessed SILValue and the location.
   LSLocationBaseMap BaseToLocIndex;
 
+  /// The indices of the locations in the LocationVault for each base.
+  llvm::DenseMap<SILValue, llvm::SmallVector<unsigned, 4>> BaseToLocations;
+
   /// Keeps all the loadstorevalues for the current function. The BitVector in
   /// each g is then laid on top of it to keep track of which LSLocation
   /// has a downward available value.
@@ -509,6 +531,9 @@ public:
   /// Process basic blocks to perform the redundant load elimination.
   void processBasicBlocksForRLE(bool Optimistic);
 
+  /// Perform the redundant load elimination within each basic block only.
+  void processBasicBlocksForLocalRLE();
+
   /// Returns the alias analysis we will use during all computations.
   AliasAnalysis *getAA() const { return AA; }
 
@@ -521,6 +546,14 @@ public:
   /// Returns the SILValue base to bit index.
   LSLocationBaseMap &getBM() { return BaseToLocIndex; }
 
+  /// Returns the indices of the locations with the base \p Base.
+  ArrayRef<unsigned> getLocationsWithBase(SILValue Base) {
+    auto Iter = BaseToLocations.find(Base);
+    if (Iter == BaseToLocations.end())
+      return {};
+    return Iter->second;
+  }
+
   /// Return the BlockState for the basic block this basic block belongs to.
   BlockState &getBlockState(SILBasicBlock *B) { return BBToLocState[B]; }
 
@@ -737,9 +770,8 @@ void BlockState::updateGenKillSetForWrite(RLEContext &Ctx, unsigned B) {
   // This is a store, invalidate any location that this location may alias, as
   // their values can no longer be forwarded.
   LSLocation &R = Ctx.getLocation(B);
-  for (unsigned i = 0; i < LocationNum; ++i) {
-    if (!isTrackingLocation(ForwardSetMax, i))
-      continue;
+  for (int i = ForwardSetMax.find_first(); i != -1;
+       i = ForwardSetMax.find_next(i)) {
     LSLocation &L = Ctx.getLocation(i);
     if (!L.isMayAliasLSLocation(R, Ctx.getAA()))
       continue;
@@ -765,9 +797,8 @@ void BlockState::updateForwardSetForWrite(RLEContext &Ctx, unsigned B) {
   // This is a store, invalidate any location that this location may alias, as
   // their values can no longer be forwarded.
   LSLocation &R = Ctx.getLocation(B);
-  for (unsigned i = 0; i < LocationNum; ++i) {
-    if (!isTrackingLocation(ForwardSetIn, i))
-      continue;
+  for (int i = ForwardSetIn.find_first(); i != -1;
+       i = ForwardSetIn.find_next(i)) {
     LSLocation &L = Ctx.getLocation(i);
     if (!L.isMayAliasLSLocation(R, Ctx.getAA()))
       continue;
@@ -784,9 +815,8 @@ void BlockState::updateForwardSetAndValForWrite(RLEContext &Ctx, unsigned L,
   // This is a store, invalidate any location that this location may alias, as
   // their values can no longer be forwarded.
   LSLocation &R = Ctx.getLocation(L);
-  for (unsigned i = 0; i < LocationNum; ++i) {
-    if (!isTrackingLocation(ForwardSetIn, i))
-      continue;
+  for (int i = ForwardSetIn.find_first(); i != -1;
+       i = ForwardSetIn.find_next(i)) {
     LSLocation &L = Ctx.getLocation(i);
     if (!L.isMayAliasLSLocation(R, Ctx.getAA()))
       continue;
@@ -930,9 +960,8 @@ void BlockState::processLoadInst(RLEContext &Ctx, LoadInst *LI, RLEKind Kind) {
 void BlockState::processUnknownWriteInstForGenKillSet(RLEContext &Ctx,
                                                       SILInstruction *I) {
   auto *AA = Ctx.getAA();
-  for (unsigned i = 0; i < LocationNum; ++i) {
-    if (!isTrackingLocation(ForwardSetMax, i))
-      continue;
+  for (int i = ForwardSetMax.find_first(); i != -1;
+       i = ForwardSetMax.find_next(i)) {
     // Invalidate any location this instruction may write to.
     //
     // TODO: checking may alias with Base is overly conservative,
@@ -949,9 +978,8 @@ void BlockState::processUnknownWriteInstForGenKillSet(RLEContext &Ctx,
 void BlockState::processUnknownWriteInstForRLE(RLEContext &Ctx,
                                                SILInstruction *I) {
   auto *AA = Ctx.getAA();
-  for (unsigned i = 0; i < LocationNum; ++i) {
-    if (!isTrackingLocation(ForwardSetIn, i))
-      continue;
+  for (int i = ForwardSetIn.find_first(); i != -1;
+       i = ForwardSetIn.find_next(i)) {
     // Invalidate any location this instruction may write to.
     //
     // TODO: checking may alias with Base is overly conservative,
@@ -990,10 +1018,7 @@ void BlockState::processUnknownWriteInst(RLEContext &Ctx, SILInstruction *I,
 void BlockState::
 processDeallocStackInstForGenKillSet(RLEContext &Ctx, SILInstruction *I) {
   SILValue ASI = findAllocStackInst(I);
-  for (unsigned i = 0; i < LocationNum; ++i) {
-    LSLocation &R = Ctx.getLocation(i);
-    if (R.getBase() != ASI)
-      continue;
+  for (unsigned i : Ctx.getLocationsWithBase(ASI)) {
     // MayAlias.
     stopTrackingLocation(BBGenSet, i);
     startTrackingLocation(BBKillSet, i);
@@ -1003,10 +1028,7 @@ processDeallocStackInstForGenKillSet(RLEContext &Ctx, SILInstruction *I) {
 void BlockState::
 processDeallocStackInstForRLE(RLEContext &Ctx, SILInstruction *I) {
   SILValue ASI = findAllocStackInst(I);
-  for (unsigned i = 0; i < LocationNum; ++i) {
-    LSLocation &R = Ctx.getLocation(i);
-    if (R.getBase() != ASI)
-      continue;
+  for (unsigned i : Ctx.getLocationsWithBase(ASI)) {
     // MayAlias.
     stopTrackingLocation(ForwardSetIn, i);
     stopTrackingValue(ForwardValIn, i);
@@ -1105,9 +1127,11 @@ getProcessFunctionKind(unsigned LoadCount, unsigned StoreCount) {
     HandledBBs.insert(B);
   }
 
-  // Data flow may take too long to run.
-  if (BBCount * LocationCount > MaxLSLocationBBMultiplicationNone)
-    return ProcessKind::ProcessNone;
+  // Data flow may take too long to run. Only forward values within basic
+  // blocks, which is linear in the size of the function.
+  if (RLELocalOnly ||
+      BBCount * LocationCount > MaxLSLocationBBMultiplicationLocal)
+    return ProcessKind::ProcessLocal;
 
   // This function's data flow would converge in 1 iteration.
   if (RunOneIteration)
@@ -1416,6 +1440,18 @@ void RLEContext::processBasicBlocksForRLE(bool Optimistic) {
   }
 }
 
+void RLEContext::processBasicBlocksForLocalRLE() {
+  unsigned LocationNum = LocationVault.size();
+  for (SILBasicBlock *BB : PO->getReversePostOrder()) {
+    // Nothing is available at the beginning of the basic block. The bit
+    // vectors are only needed while the basic block is processed.
+    BlockState &Forwarder = getBlockState(BB);
+    Forwarder.init(BB, LocationNum, false);
+    Forwarder.processBasicBlockWithKind(*this, RLEKind::PerformRLE);
+    Forwarder.releaseLocationSets();
+  }
+}
+
 void RLEContext::runIterativeRLE() {
   // Generate the genset and killset for every basic block.
   processBasicBlocksForGenKillSet();
@@ -1459,6 +1495,9 @@ bool RLEContext::run() {
   if (Kind == ProcessKind::ProcessNone)
     return false;
 
+  for (unsigned i = 0, e = LocationVault.size(); i != e; ++i)
+    BaseToLocations[LocationVault[i].getBase()].push_back(i);
+
   // Do we run a multi-iteration data flow ?
   bool Optimistic = Kind == ProcessKind::ProcessMultipleIterations ?
                         true : false;
@@ -1469,21 +1508,25 @@ bool RLEContext::run() {
   for (auto X : PO->getPostOrder()) 
     BBToProcess.insert(X);
 
-  // For all basic blocks in the function, initialize a BB state. Since we
-  // know all the locations accessed in this function, we can resize the bit
-  // vector to the appropriate size.
-  for (auto &B : *Fn) {
-    BBToLocState[&B] = BlockState();
-    BBToLocState[&B].init(&B, LocationVault.size(), Optimistic &&
-                          BBToProcess.find(&B) != BBToProcess.end());
-  }
+  if (Kind == ProcessKind::ProcessLocal) {
+    processBasicBlocksForLocalRLE();
+  } else {
+    // For all basic blocks in the function, initialize a BB state. Since we
+    // know all the locations accessed in this function, we can resize the bit
+    // vector to the appropriate size.
+    for (auto &B : *Fn) {
+      BBToLocState[&B] = BlockState();
+      BBToLocState[&B].init(&B, LocationVault.size(), Optimistic &&
+                            BBToProcess.find(&B) != BBToProcess.end());
+    }
 
-  if (Optimistic)
-    runIterativeRLE();
+    if (Optimistic)
+      runIterativeRLE();
 
-  // We have the available value bit computed and the local forwarding value.
-  // Set up the load forwarding.
-  processBasicBlocksForRLE(Optimistic);
+    // We have the available value bit computed and the local forwarding value.
+    // Set up the load forwarding.
+    processBasicBlocksForRLE(Optimistic);
+  }
 
   // Finally, perform the redundant load replacements.
   llvm::DenseSet<SILInstruction *> InstsToDelete;
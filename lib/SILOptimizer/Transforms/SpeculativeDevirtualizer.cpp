@@ -25,6 +25,8 @@
 #include "swift/SIL/SILModule.h"
 #include "swift/SIL/InstructionUtils.h"
 #include "swift/SILOptimizer/Analysis/ClassHierarchyAnalysis.h"
+#include "swift/SILOptimizer/Analysis/ColdBlockInfo.h"
+#include "swift/SILOptimizer/Analysis/DominanceAnalysis.h"
 #include "swift/SILOptimizer/Utils/Generics.h"
 #include "swift/SILOptimizer/PassManager/Passes.h"
 #include "swift/SILOptimizer/PassManager/PassManager.h"
@@ -248,7 +250,9 @@ static bool isDefaultCaseKnown(ClassHierarchyAnalysis *CHA,
   // Only consider 'private' members, unless we are in whole-module compilation.
   switch (CD->getEffectiveAccess()) {
   case Accessibility::Open:
-    return false;
+    if (!AI.getModule().isWholeProgram())
+      return false;
+    break;
   case Accessibility::Public:
   case Accessibility::Internal:
     if (!AI.getModule().isWholeModule())
@@ -541,9 +545,18 @@ namespace {
 
       bool Changed = false;
 
+      // With profile data don't speculate in code which was never executed:
+      // it would only increase code size.
+      Optional<uint64_t> EntryCount = getFunction()->getEntryCount();
+      if (EntryCount && *EntryCount == 0)
+        return;
+      ColdBlockInfo ColdBlocks(PM->getAnalysis<DominanceAnalysis>());
+
       // Collect virtual calls that may be specialized.
       SmallVector<FullApplySite, 16> ToSpecialize;
       for (auto &BB : *getFunction()) {
+        if (EntryCount && ColdBlocks.isCold(&BB))
+          continue;
         for (auto II = BB.begin(), IE = BB.end(); II != IE; ++II) {
           FullApplySite AI = FullApplySite::isa(&*II);
           if (AI && isa<ClassMethodInst>(AI.getCallee()))
@@ -26,10 +26,16 @@
 #include "swift/SILOptimizer/Analysis/SideEffectAnalysis.h"
 #include "swift/SILOptimizer/Analysis/Analysis.h"
 #include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 
 using namespace swift;
 
+static llvm::cl::opt<bool> PrintAACacheStats(
+    "aa-dumper-print-cache-stats", llvm::cl::init(false),
+    llvm::cl::desc("Print the hit rate of the alias analysis cache after "
+                   "dumping the alias relations"));
+
 //===----------------------------------------------------------------------===//
 //                               Value Gatherer
 //===----------------------------------------------------------------------===//
@@ -95,6 +101,12 @@ class SILAADumper : public SILModuleTransform {
       }
           llvm::outs() << "\n";
     }
+
+    if (PrintAACacheStats) {
+      AliasAnalysis *AA = PM->getAnalysis<AliasAnalysis>();
+      llvm::outs() << "AA cache: " << AA->getNumAliasCacheHits() << " hits, "
+                   << AA->getNumAliasCacheMisses() << " misses\n";
+    }
   }
 
   StringRef getName() override { return "AA Dumper"; }
@@ -551,6 +551,8 @@ SILBasicBlock *swift::splitBasicBlockAndBranch(SILBuilder &B,
   auto *NewBB = OrigBB->split(SplitBeforeInst->getIterator());
   B.setInsertionPoint(OrigBB);
   B.createBranch(SplitBeforeInst->getLoc(), NewBB);
+  if (auto Count = OrigBB->getProfileCount())
+    NewBB->setProfileCount(*Count);
 
   // Update the dominator tree.
   if (DT) {
@@ -583,8 +585,19 @@ SILBasicBlock *swift::splitEdge(TermInst *T, unsigned EdgeIdx,
 
   SILBasicBlock *DestBB = T->getSuccessors()[EdgeIdx];
 
+  // The new block is executed as often as the edge, if that is known.
+  Optional<uint64_t> EdgeCount;
+  if (auto *CBI = dyn_cast<CondBranchInst>(T)) {
+    if (auto Counts = CBI->getEdgeCounts())
+      EdgeCount = EdgeIdx == 0 ? Counts->first : Counts->second;
+  } else if (T->getSuccessors().size() == 1) {
+    EdgeCount = SrcBB->getProfileCount();
+  }
+
   // Create a new basic block in the edge, and insert it after the SrcBB.
   auto *EdgeBB = Fn->createBasicBlock(SrcBB);
+  if (EdgeCount)
+    EdgeBB->setProfileCount(*EdgeCount);
 
   SmallVector<SILValue, 16> Args;
   getEdgeArgs(T, EdgeIdx, EdgeBB, Args);
@@ -157,7 +157,9 @@ bool isEffectivelyFinalMethod(FullApplySite AI,
 /// - it is really final
 /// - or it is private and has not sub-classes
 /// - or it is an internal class without sub-classes and
-///   it is a whole-module compilation.
+///   it is a whole-module compilation
+/// - or it is an open class without sub-classes and
+///   it is a whole-program compilation.
 static bool isKnownFinalClass(ClassDecl *CD, SILModule &M,
                               ClassHierarchyAnalysis *CHA) {
   const DeclContext *DC = M.getAssociatedContext();
@@ -180,7 +182,9 @@ static bool isKnownFinalClass(ClassDecl *CD, SILModule &M,
   // Only consider 'private' members, unless we are in whole-module compilation.
   switch (CD->getEffectiveAccess()) {
   case Accessibility::Open:
-    return false;
+    if (!M.isWholeProgram())
+      return false;
+    break;
   case Accessibility::Public:
   case Accessibility::Internal:
     if (!M.isWholeModule())
@@ -201,7 +205,9 @@ static bool isKnownFinalClass(ClassDecl *CD, SILModule &M,
     if (!CHA->hasKnownDirectSubclasses(CD)) {
       switch (CD->getEffectiveAccess()) {
       case Accessibility::Open:
-        return false;
+        if (!M.isWholeProgram())
+          return false;
+        break;
       case Accessibility::Public:
       case Accessibility::Internal:
         if (!M.isWholeModule())
@@ -727,23 +727,18 @@ bool swift::isWhitelistedSpecialization(StringRef SpecName) {
   return false;
 }
 
-/// Try to look up an existing specialization in the specialization cache.
-/// If it is found, it tries to link this specialization.
+/// Try to look up an existing public specialization in the imported modules.
 ///
-/// For now, it performs a lookup only in the standard library.
-/// But in the future, one could think of maintaining a cache
-/// of optimized specializations.
+/// Besides the whitelisted specializations of the standard library, these are
+/// the specializations which a module exports because of @_specialize
+/// attributes, e.g. ones requested by a prespecialization manifest.
 static SILFunction *lookupExistingSpecialization(SILModule &M,
                                                  StringRef FunctionName) {
-  // Try to link existing specialization only in -Onone mode.
-  // All other compilation modes perform specialization themselves.
-  // TODO: Cache optimized specializations and perform lookup here?
-  // Only check that this function exists, but don't read
-  // its body. It can save some compile-time.
-  if (isWhitelistedSpecialization(FunctionName))
-    return M.hasFunction(FunctionName, SILLinkage::PublicExternal);
-
-  return nullptr;
+  // This is a lookup in the serialized function tables of the imported
+  // modules. It only checks that the function exists and doesn't read its
+  // body. Callers should only ask for specializations of functions defined
+  // in other modules; the UsePrespecialized pass counts these lookups.
+  return M.hasFunction(FunctionName, SILLinkage::PublicExternal);
 }
 
 SILFunction *swift::lookupPrespecializedSymbol(SILModule &M,
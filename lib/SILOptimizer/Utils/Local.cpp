@@ -2697,7 +2697,8 @@ bool swift::calleesAreStaticallyKnowable(SILModule &M, SILDeclRef Decl) {
   // Only consider 'private' members, unless we are in whole-module compilation.
   switch (AFD->getEffectiveAccess()) {
   case Accessibility::Open:
-    return false;
+    // No other module can override the member in a whole program.
+    return M.isWholeProgram();
   case Accessibility::Public:
     if (isa<ConstructorDecl>(AFD)) {
       // Constructors are special: a derived class in another module can
@@ -2705,7 +2706,7 @@ bool swift::calleesAreStaticallyKnowable(SILModule &M, SILDeclRef Decl) {
       // constructor itself is not open.
       auto *ND = AFD->getExtensionType()->getNominalOrBoundGenericNominal();
       if (ND->getEffectiveAccess() == Accessibility::Open)
-        return false;
+        return M.isWholeProgram();
     }
     SWIFT_FALLTHROUGH;
   case Accessibility::Internal:
@@ -128,6 +128,9 @@ bool SILInliner::inlineFunction(FullApplySite AI, ArrayRef<SILValue> Args) {
     // Split the BB and do NOT create a branch between the old and new
     // BBs; we will create the appropriate terminator manually later.
     ReturnToBB = CallerBB->split(InsertPoint);
+    // The callee returns once for every execution of the call.
+    if (auto Count = CallerBB->getProfileCount())
+      ReturnToBB->setProfileCount(*Count);
     // Place the return-to BB after all the other mapped BBs.
     if (InsertBeforeBB)
       F.getBlocks().splice(SILFunction::iterator(InsertBeforeBB), F.getBlocks(),
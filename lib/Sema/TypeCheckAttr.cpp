@@ -1521,7 +1521,64 @@ void AttributeChecker::visitSpecializeAttr(SpecializeAttr *attr) {
     ConcreteDeclRef(DC->getASTContext(), FD, substitutions));
 }
 
+/// Adds the @_specialize attributes which the prespecialization manifest
+/// requests for \p AFD, see LangOptions::Prespecializations.
+static void addManifestSpecializeAttrs(ASTContext &Ctx,
+                                       AbstractFunctionDecl *AFD) {
+  if (!AFD->getGenericSignature())
+    return;
+
+  // Don't add the attributes again if the attributes are checked twice.
+  for (auto *Attr : AFD->getAttrs().getAttributes<SpecializeAttr>()) {
+    if (Attr->isImplicit())
+      return;
+  }
+
+  std::string Name;
+  {
+    llvm::raw_string_ostream OS(Name);
+    auto *DC = AFD->getDeclContext();
+    if (auto *NTD = DC->getAsNominalTypeOrNominalTypeExtensionContext())
+      OS << NTD->getName() << '.';
+    OS << AFD->getFullName();
+  }
+  StringRef ModuleName = AFD->getModuleContext()->getName().str();
+
+  for (auto &Request : Ctx.LangOpts.Prespecializations) {
+    StringRef Function = Request.Function;
+    if (Function.size() > ModuleName.size() &&
+        Function.startswith(ModuleName) &&
+        Function[ModuleName.size()] == '.')
+      Function = Function.drop_front(ModuleName.size() + 1);
+    if (Function != Name)
+      continue;
+
+    // Build the type reprs the parser would have produced for
+    // @_specialize(<types>).
+    SmallVector<TypeLoc, 2> TypeLocs;
+    for (StringRef TypeName : Request.Types) {
+      SmallVector<StringRef, 2> Parts;
+      TypeName.split(Parts, '.');
+      SmallVector<ComponentIdentTypeRepr *, 2> Components;
+      for (StringRef Part : Parts) {
+        Components.push_back(new (Ctx) SimpleIdentTypeRepr(
+            SourceLoc(), Ctx.getIdentifier(Part)));
+      }
+      TypeLocs.push_back(TypeLoc(IdentTypeRepr::create(Ctx, Components)));
+    }
+    auto *Attr = SpecializeAttr::create(Ctx, SourceLoc(), SourceRange(),
+                                        TypeLocs);
+    Attr->setImplicit(true);
+    AFD->getAttrs().add(Attr);
+  }
+}
+
 void TypeChecker::checkDeclAttributes(Decl *D) {
+  if (!Context.LangOpts.Prespecializations.empty()) {
+    if (auto *AFD = dyn_cast<AbstractFunctionDecl>(D))
+      addManifestSpecializeAttrs(Context, AFD);
+  }
+
   AttributeChecker Checker(*this, D);
 
   for (auto attr : D->getAttrs()) {
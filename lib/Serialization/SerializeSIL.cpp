@@ -182,7 +182,7 @@ namespace {
     bool ShouldSerializeAll;
 
     void addMandatorySILFunction(const SILFunction *F,
-                                 bool emitDeclarationsForOnoneSupport);
+                                 bool emitDeclarationOnly);
     void addReferencedSILFunction(const SILFunction *F,
                                   bool DeclOnly = false);
     void processSILFunctionWorklist();
@@ -231,24 +231,25 @@ namespace {
 } // end anonymous namespace
 
 void SILSerializer::addMandatorySILFunction(const SILFunction *F,
-                                            bool emitDeclarationsForOnoneSupport) {
-  // If this function is not fragile, don't do anything.
-  if (!shouldEmitFunctionBody(F))
+                                            bool emitDeclarationOnly) {
+  // If this function is not fragile, don't do anything, unless only its
+  // declaration is requested.
+  if (!emitDeclarationOnly && !shouldEmitFunctionBody(F))
     return;
 
   auto iter = FuncsToEmit.find(F);
   if (iter != FuncsToEmit.end()) {
     // We've already visited this function. Make sure that we decided
     // to emit its body the first time around.
-    assert(iter->second == emitDeclarationsForOnoneSupport
+    assert(iter->second == emitDeclarationOnly
            && "Already emitting declaration");
     return;
   }
 
   // We haven't seen this function before. Record that we want to
   // emit its body, and add it to the worklist.
-  FuncsToEmit[F] = emitDeclarationsForOnoneSupport;
-  if (!emitDeclarationsForOnoneSupport)
+  FuncsToEmit[F] = emitDeclarationOnly;
+  if (!emitDeclarationOnly)
     Worklist.push_back(F);
 }
 
@@ -1953,6 +1954,7 @@ void SILSerializer::writeSILBlock(const SILModule *SILMod) {
   // Go through all the SILFunctions in SILMod and write out any
   // mandatory function bodies.
   for (const SILFunction &F : *SILMod) {
+    bool emitDeclarationOnly = false;
     if (emitDeclarationsForOnoneSupport) {
       // Only declarations of whitelisted pre-specializations from with
       // public linkage need to be serialized as they will be used
@@ -1961,9 +1963,16 @@ void SILSerializer::writeSILBlock(const SILModule *SILMod) {
       if (!hasPublicVisibility(F.getLinkage()) ||
           !isWhitelistedSpecialization(F.getName()))
         continue;
+      emitDeclarationOnly = true;
+    } else if (F.isKeepAsPublic() && hasPublicVisibility(F.getLinkage()) &&
+               !shouldEmitFunctionBody(&F)) {
+      // The same holds for the specializations which this module exports
+      // because of @_specialize attributes. They are not fragile, so their
+      // bodies are not serialized.
+      emitDeclarationOnly = true;
     }
 
-    addMandatorySILFunction(&F, emitDeclarationsForOnoneSupport);
+    addMandatorySILFunction(&F, emitDeclarationOnly);
     processSILFunctionWorklist();
   }
 
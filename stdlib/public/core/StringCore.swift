@@ -28,6 +28,8 @@
 public struct _StringCore {
   //===--------------------------------------------------------------------===//
   // Internals
+  // The runtime copies Strings in tuples by retaining `_owner` directly. It
+  // finds the owner by name, and the runtime unit tests check this layout.
   public var _baseAddress: UnsafeMutableRawPointer?
   var _countAndFlags: UInt
   public var _owner: AnyObject?
@@ -19,6 +19,7 @@
 #if defined(__ELF__) || defined(__ANDROID__)
 
 #include "ImageInspection.h"
+#include "StartupTrace.h"
 #include <elf.h>
 #include <link.h>
 #include <dlfcn.h>
@@ -72,7 +73,19 @@ static int iteratePHDRCallback(struct dl_phdr_info *info,
   memcpy(&conformancesSize, conformances, sizeof(conformancesSize));
   conformances += sizeof(conformancesSize);
 
-  inspectArgs->addBlock(conformances, conformancesSize);
+  const char *imageName = info->dlpi_name;
+  if (!imageName || imageName[0] == '\0')
+    imageName = "<main executable>";
+  else if (isStartupTraceEnabled())
+    // The trace is written at exit, but dlpi_name is owned by the dynamic
+    // linker and goes away if the image is unloaded.
+    imageName = strdup(imageName);
+
+  {
+    StartupTraceScope trace(StartupTraceEventKind::ImageRegistration,
+                            inspectArgs->symbolName, imageName);
+    inspectArgs->addBlock(conformances, conformancesSize);
+  }
 
   dlclose(handle);
   return 0;
@@ -43,6 +43,7 @@
 #include "ExistentialMetadataImpl.h"
 #include "swift/Runtime/Debug.h"
 #include "Private.h"
+#include "StartupTrace.h"
 
 #if defined(__APPLE__)
 #include <mach/vm_page_size.h>
@@ -235,8 +236,11 @@ swift::swift_getGenericMetadata(GenericMetadata *pattern,
 
   auto entry = getCache(pattern).findOrAdd(genericArgs, numGenericArgs,
     [&]() -> GenericCacheEntry* {
+      StartupTraceScope trace(StartupTraceEventKind::MetadataInstantiation);
+
       // Create new metadata to cache.
       auto metadata = pattern->CreateFunction(pattern, arguments);
+      trace.setSubject(metadata);
       auto entry = GenericCacheEntry::getFromMetadata(pattern, metadata);
       entry->Value = metadata;
       return entry;
@@ -245,6 +249,39 @@ swift::swift_getGenericMetadata(GenericMetadata *pattern,
   return entry->Value;
 }
 
+const Metadata *
+swift::swift_getPrespecializedGenericMetadata(GenericMetadata *pattern,
+                                              const void *arguments,
+                                              ValueMetadata *candidate) {
+  auto genericArgs = (const void * const *) arguments;
+  size_t numGenericArgs = pattern->NumKeyArguments;
+
+  auto entry = getCache(pattern).findOrAdd(genericArgs, numGenericArgs,
+    [&]() -> GenericCacheEntry* {
+      // The candidate lives in the image which emitted it, so the cache
+      // entry only holds the key.
+      auto entry = GenericCacheEntry::allocate(
+                              unsafeGetInitializedCache(pattern).getAllocator(),
+                              genericArgs, numGenericArgs,
+                              /*payloadSize*/ 0);
+
+      // The nominal type descriptor is referenced relatively, so the
+      // compiler can't reference it from another image.  Copy it from the
+      // pattern before the metadata is published.
+      auto patternBytes =
+        reinterpret_cast<const char*>(pattern->getMetadataTemplate()) +
+        pattern->AddressPoint;
+      auto patternMetadata =
+        reinterpret_cast<const ValueMetadata*>(patternBytes);
+      candidate->Description = patternMetadata->Description.get();
+
+      entry->Value = candidate;
+      return entry;
+    });
+
+  return entry->Value;
+}
+
 /***************************************************************************/
 /*** Objective-C class wrappers ********************************************/
 /***************************************************************************/
@@ -420,7 +457,14 @@ swift::swift_getFunctionTypeMetadata3(FunctionTypeFlags flags,
 const FunctionTypeMetadata *
 swift::swift_getFunctionTypeMetadata(const void *flagsArgsAndResult[]) {
   FunctionCacheEntry::Key key = { flagsArgsAndResult };
-  return &FunctionTypes.getOrInsert(key).first->Data;
+  uint64_t traceStart = isStartupTraceEnabled() ? getStartupTraceTime() : 0;
+  auto result = FunctionTypes.getOrInsert(key);
+  if (traceStart && result.second)
+    recordStartupTraceEvent(StartupTraceEventKind::MetadataInstantiation,
+                            traceStart, getStartupTraceTime(),
+                            static_cast<const Metadata *>(&result.first->Data),
+                            nullptr);
+  return &result.first->Data;
 }
 
 FunctionCacheEntry::FunctionCacheEntry(Key key) {
@@ -469,6 +513,45 @@ FunctionCacheEntry::FunctionCacheEntry(Key key) {
 
 namespace {
 
+/// An instruction of the layout string of a tuple.
+///
+/// The layout string lists the elements of a tuple which are not POD, in
+/// order, followed by an End instruction.  The generic tuple value witnesses
+/// interpret it instead of calling the value witnesses of every element: the
+/// POD elements are copied along with the rest of the tuple by memcpy, and
+/// strong references, including the owner of a String, are retained and
+/// released directly.
+struct TupleLayoutOp {
+  enum Kind : uint8_t {
+    /// The end of the layout string.
+    End,
+
+    /// A strong reference to a native Swift object.
+    NativeStrong,
+
+    /// A Builtin.BridgeObject.
+    BridgeStrong,
+
+#if SWIFT_OBJC_INTEROP
+    /// A strong reference to an object which may not be a native Swift
+    /// object.
+    UnknownStrong,
+#endif
+
+    /// Any other element, which is copied and destroyed with its own value
+    /// witnesses.
+    Witness,
+  };
+
+  Kind OpKind;
+
+  /// The offset of the reference or element within the tuple.
+  size_t Offset;
+
+  /// The type of the element.
+  const Metadata *Type;
+};
+
 class TupleCacheEntry {
 public:
   // NOTE: if you change the layout of this type, you'll also need
@@ -522,12 +605,19 @@ public:
     return 0;
   }
 
+  /// The elements are followed by the layout string, which has at most one
+  /// instruction per element plus the terminator.
+  static size_t getExtraAllocationSize(size_t numElements) {
+    return numElements * sizeof(TupleTypeMetadata::Element) +
+           (numElements + 1) * sizeof(TupleLayoutOp);
+  }
+
   static size_t getExtraAllocationSize(const Key &key,
                                        const ValueWitnessTable *proposed) {
-    return key.NumElements * sizeof(TupleTypeMetadata::Element);
+    return getExtraAllocationSize(key.NumElements);
   }
   size_t getExtraAllocationSize() const {
-    return Data.NumElements * sizeof(TupleTypeMetadata::Element);
+    return getExtraAllocationSize(Data.NumElements);
   }
 };
 
@@ -542,6 +632,210 @@ static const ValueWitnessTable *tuple_getValueWitnesses(const Metadata *metatype
   return ((const ExtraInhabitantsValueWitnessTable*) asFullMetadata(metatype)) - 1;
 }
 
+/// Given a tuple metatype created by swift_getTupleTypeMetadata, produce its
+/// layout string.
+static const TupleLayoutOp *tuple_getLayoutString(const Metadata *_metatype) {
+  auto &metatype = *(const TupleTypeMetadata*) _metatype;
+  return reinterpret_cast<const TupleLayoutOp *>(
+           metatype.getElements() + metatype.NumElements);
+}
+
+/// Nominal type descriptor for Swift.String.
+extern "C" const NominalTypeDescriptor _TMnSS;
+
+/// If \p name is the only field of the struct \p type which is not POD,
+/// return its type and set \p fieldOffset to its offset.  Otherwise return
+/// null.
+static const Metadata *getOnlyNonPODField(const StructMetadata *type,
+                                          const char *name,
+                                          size_t &fieldOffset) {
+  auto &description = type->getDescription()->Struct;
+  const FieldType *fieldTypes = type->getFieldTypes();
+  auto fieldOffsets = type->getFieldOffsets();
+  const char *fieldName = description.FieldNames.get();
+  if (!fieldTypes || !fieldOffsets || !fieldName)
+    return nullptr;
+
+  const Metadata *result = nullptr;
+  for (unsigned i = 0; i != description.NumFields;
+       ++i, fieldName += strlen(fieldName) + 1) {
+    FieldType fieldType = fieldTypes[i];
+    if (!fieldType.isWeak() && !fieldType.isIndirect() &&
+        fieldType.getType()->getValueWitnesses()->isPOD())
+      continue;
+    if (result || strcmp(fieldName, name) != 0 || fieldType.isWeak() ||
+        fieldType.isIndirect())
+      return nullptr;
+    result = fieldType.getType();
+    fieldOffset = fieldOffsets[i];
+  }
+  return result;
+}
+
+/// Produce the layout string instruction for a String element.
+///
+/// A String is a _StringCore, whose only non-trivial field is the
+/// 'AnyObject?' owner (see StringCore.swift).  The offset of the owner is
+/// taken from the field offset vectors of both structs.  If the fields don't
+/// match these expectations, the String is copied with its value witnesses.
+static TupleLayoutOp getStringLayoutOp(const StructMetadata *type,
+                                       size_t offset) {
+  TupleLayoutOp witnessOp = {TupleLayoutOp::Witness, offset, type};
+
+  size_t coreOffset, ownerOffset;
+  auto coreType = getOnlyNonPODField(type, "_core", coreOffset);
+  if (!coreType || !isa<StructMetadata>(coreType))
+    return witnessOp;
+  auto ownerType = getOnlyNonPODField(cast<StructMetadata>(coreType),
+                                      "_owner", ownerOffset);
+  if (!ownerType || ownerType->getKind() != MetadataKind::Optional)
+    return witnessOp;
+
+  // An optional reference is a null pointer if it is nil, which the
+  // reference counting entry points accept.
+  auto payloadWitnesses = cast<EnumMetadata>(ownerType)->getGenericArgs()[0]
+                            ->getValueWitnesses();
+#if SWIFT_OBJC_INTEROP
+  if (payloadWitnesses == &_TWVBO)
+    return {TupleLayoutOp::UnknownStrong, offset + coreOffset + ownerOffset,
+            type};
+#endif
+  if (payloadWitnesses == &_TWVBo)
+    return {TupleLayoutOp::NativeStrong, offset + coreOffset + ownerOffset,
+            type};
+  return witnessOp;
+}
+
+/// Produce the layout string instruction for a non-POD tuple element.
+static TupleLayoutOp getTupleLayoutOp(const Metadata *type, size_t offset) {
+  if (auto structType = dyn_cast<StructMetadata>(type)) {
+    if (structType->getDescription() == &_TMnSS)
+      return getStringLayoutOp(structType, offset);
+  }
+
+  auto witnesses = type->getValueWitnesses();
+  if (witnesses == &_TWVBo)
+    return {TupleLayoutOp::NativeStrong, offset, type};
+  // A thick function is a function pointer followed by a native context.
+  if (witnesses == &_TWVFT_T_)
+    return {TupleLayoutOp::NativeStrong, offset + sizeof(void*), type};
+  if (witnesses == &_TWVBb)
+    return {TupleLayoutOp::BridgeStrong, offset, type};
+#if SWIFT_OBJC_INTEROP
+  if (witnesses == &_TWVBO)
+    return {TupleLayoutOp::UnknownStrong, offset, type};
+#endif
+  return {TupleLayoutOp::Witness, offset, type};
+}
+
+/// Destroy the non-POD elements of a tuple.
+static void tuple_destroyWithLayout(char *tuple, const TupleLayoutOp *op) {
+  for (; op->OpKind != TupleLayoutOp::End; ++op) {
+    char *elt = tuple + op->Offset;
+    switch (op->OpKind) {
+    case TupleLayoutOp::NativeStrong:
+      swift_release(*reinterpret_cast<HeapObject**>(elt));
+      break;
+    case TupleLayoutOp::BridgeStrong:
+      swift_bridgeObjectRelease(*reinterpret_cast<void**>(elt));
+      break;
+#if SWIFT_OBJC_INTEROP
+    case TupleLayoutOp::UnknownStrong:
+      swift_unknownRelease(*reinterpret_cast<void**>(elt));
+      break;
+#endif
+    case TupleLayoutOp::Witness:
+      op->Type->getValueWitnesses()->destroy((OpaqueValue*) elt, op->Type);
+      break;
+    case TupleLayoutOp::End:
+      // Handled by the loop condition.
+      break;
+    }
+  }
+}
+
+/// Assign the tuple src to dest by take. The elements are assigned one after
+/// the other, like the assignWithTake witnesses of the elements would do, so
+/// that the old value of an element is released before the next element is
+/// assigned. The POD bytes in front of each non-POD element are copied just
+/// before it.
+static void tuple_assignWithTakeWithLayout(char *dest, char *src,
+                                           const TupleLayoutOp *op,
+                                           size_t size) {
+  size_t copied = 0;
+  for (; op->OpKind != TupleLayoutOp::End; ++op) {
+    memcpy(dest + copied, src + copied, op->Offset - copied);
+    char *destElt = dest + op->Offset;
+    char *srcElt = src + op->Offset;
+    switch (op->OpKind) {
+    case TupleLayoutOp::NativeStrong: {
+      auto old = *reinterpret_cast<HeapObject**>(destElt);
+      *reinterpret_cast<HeapObject**>(destElt) =
+        *reinterpret_cast<HeapObject**>(srcElt);
+      swift_release(old);
+      copied = op->Offset + sizeof(void*);
+      break;
+    }
+    case TupleLayoutOp::BridgeStrong: {
+      auto old = *reinterpret_cast<void**>(destElt);
+      *reinterpret_cast<void**>(destElt) = *reinterpret_cast<void**>(srcElt);
+      swift_bridgeObjectRelease(old);
+      copied = op->Offset + sizeof(void*);
+      break;
+    }
+#if SWIFT_OBJC_INTEROP
+    case TupleLayoutOp::UnknownStrong: {
+      auto old = *reinterpret_cast<void**>(destElt);
+      *reinterpret_cast<void**>(destElt) = *reinterpret_cast<void**>(srcElt);
+      swift_unknownRelease(old);
+      copied = op->Offset + sizeof(void*);
+      break;
+    }
+#endif
+    case TupleLayoutOp::Witness: {
+      auto witnesses = op->Type->getValueWitnesses();
+      witnesses->assignWithTake((OpaqueValue*) destElt, (OpaqueValue*) srcElt,
+                                op->Type);
+      copied = op->Offset + witnesses->size;
+      break;
+    }
+    case TupleLayoutOp::End:
+      // Handled by the loop condition.
+      break;
+    }
+  }
+  memcpy(dest + copied, src + copied, size - copied);
+}
+
+/// Finish copying a tuple whose bytes were copied from src to dest: retain
+/// the references and copy the remaining non-POD elements.
+static void tuple_copyWithLayout(char *dest, char *src,
+                                 const TupleLayoutOp *op) {
+  for (; op->OpKind != TupleLayoutOp::End; ++op) {
+    char *destElt = dest + op->Offset;
+    switch (op->OpKind) {
+    case TupleLayoutOp::NativeStrong:
+      swift_retain(*reinterpret_cast<HeapObject**>(destElt));
+      break;
+    case TupleLayoutOp::BridgeStrong:
+      swift_bridgeObjectRetain(*reinterpret_cast<void**>(destElt));
+      break;
+#if SWIFT_OBJC_INTEROP
+    case TupleLayoutOp::UnknownStrong:
+      swift_unknownRetain(*reinterpret_cast<void**>(destElt));
+      break;
+#endif
+    case TupleLayoutOp::Witness:
+      op->Type->getValueWitnesses()->initializeWithCopy(
+        (OpaqueValue*) destElt, (OpaqueValue*) (src + op->Offset), op->Type);
+      break;
+    case TupleLayoutOp::End:
+      // Handled by the loop condition.
+      break;
+    }
+  }
+}
+
 /// Generic tuple value witness for 'projectBuffer'.
 template <bool IsPOD, bool IsInline>
 static OpaqueValue *tuple_projectBuffer(ValueBuffer *buffer,
@@ -597,12 +891,7 @@ static void tuple_destroy(OpaqueValue *tuple, const Metadata *_metadata) {
 
   if (IsPOD) return;
 
-  for (size_t i = 0, e = metadata.NumElements; i != e; ++i) {
-    auto &eltInfo = metadata.getElements()[i];
-    OpaqueValue *elt = eltInfo.findIn(tuple);
-    auto eltWitnesses = eltInfo.Type->getValueWitnesses();
-    eltWitnesses->destroy(elt, eltInfo.Type);
-  }
+  tuple_destroyWithLayout((char*) tuple, tuple_getLayoutString(&metadata));
 }
 
 /// Generic tuple value witness for 'destroyArray'.
@@ -616,10 +905,11 @@ static void tuple_destroyArray(OpaqueValue *array, size_t n,
   if (IsPOD) return;
 
   size_t stride = tuple_getValueWitnesses(&metadata)->stride;
+  const TupleLayoutOp *layout = tuple_getLayoutString(&metadata);
   char *bytes = (char*)array;
 
   while (n--) {
-    tuple_destroy<IsPOD, IsInline>((OpaqueValue*)bytes, _metadata);
+    tuple_destroyWithLayout(bytes, layout);
     bytes += stride;
   }
 }
@@ -693,9 +983,11 @@ static OpaqueValue *tuple_initializeWithCopy(OpaqueValue *dest,
   assert(IsPOD == tuple_getValueWitnesses(metatype)->isPOD());
   assert(IsInline == tuple_getValueWitnesses(metatype)->isValueInline());
 
-  if (IsPOD) return tuple_memcpy(dest, src, metatype);
-  return tuple_forEachField(dest, src, metatype,
-                            &ValueWitnessTable::initializeWithCopy);
+  tuple_memcpy(dest, src, metatype);
+  if (!IsPOD)
+    tuple_copyWithLayout((char*) dest, (char*) src,
+                         tuple_getLayoutString(metatype));
+  return dest;
 }
 
 /// Generic tuple value witness for 'initializeArrayWithCopy'.
@@ -707,16 +999,16 @@ static OpaqueValue *tuple_initializeArrayWithCopy(OpaqueValue *dest,
   assert(IsPOD == tuple_getValueWitnesses(metatype)->isPOD());
   assert(IsInline == tuple_getValueWitnesses(metatype)->isValueInline());
 
-  if (IsPOD) return tuple_memcpy_array(dest, src, n, metatype);
+  tuple_memcpy_array(dest, src, n, metatype);
+  if (IsPOD) return dest;
 
   char *destBytes = (char*)dest;
   char *srcBytes = (char*)src;
   size_t stride = tuple_getValueWitnesses(metatype)->stride;
+  const TupleLayoutOp *layout = tuple_getLayoutString(metatype);
 
   while (n--) {
-    tuple_initializeWithCopy<IsPOD, IsInline>((OpaqueValue*)destBytes,
-                                              (OpaqueValue*)srcBytes,
-                                              metatype);
+    tuple_copyWithLayout(destBytes, srcBytes, layout);
     destBytes += stride; srcBytes += stride;
   }
 
@@ -731,7 +1023,8 @@ static OpaqueValue *tuple_initializeWithTake(OpaqueValue *dest,
   assert(IsPOD == tuple_getValueWitnesses(metatype)->isPOD());
   assert(IsInline == tuple_getValueWitnesses(metatype)->isValueInline());
 
-  if (IsPOD) return tuple_memcpy(dest, src, metatype);
+  if (IsPOD || tuple_getValueWitnesses(metatype)->isBitwiseTakable())
+    return tuple_memcpy(dest, src, metatype);
   return tuple_forEachField(dest, src, metatype,
                             &ValueWitnessTable::initializeWithTake);
 }
@@ -746,7 +1039,8 @@ static OpaqueValue *tuple_initializeArrayWithTakeFrontToBack(
   assert(IsPOD == tuple_getValueWitnesses(metatype)->isPOD());
   assert(IsInline == tuple_getValueWitnesses(metatype)->isValueInline());
 
-  if (IsPOD) return tuple_memmove_array(dest, src, n, metatype);
+  if (IsPOD || tuple_getValueWitnesses(metatype)->isBitwiseTakable())
+    return tuple_memmove_array(dest, src, n, metatype);
 
   char *destBytes = (char*)dest;
   char *srcBytes = (char*)src;
@@ -772,7 +1066,8 @@ static OpaqueValue *tuple_initializeArrayWithTakeBackToFront(
   assert(IsPOD == tuple_getValueWitnesses(metatype)->isPOD());
   assert(IsInline == tuple_getValueWitnesses(metatype)->isValueInline());
 
-  if (IsPOD) return tuple_memmove_array(dest, src, n, metatype);
+  if (IsPOD || tuple_getValueWitnesses(metatype)->isBitwiseTakable())
+    return tuple_memmove_array(dest, src, n, metatype);
 
   size_t stride = tuple_getValueWitnesses(metatype)->stride;
   char *destBytes = (char*)dest + n * stride;
@@ -807,8 +1102,11 @@ static OpaqueValue *tuple_assignWithTake(OpaqueValue *dest,
                                          OpaqueValue *src,
                                          const Metadata *metatype) {
   if (IsPOD) return tuple_memcpy(dest, src, metatype);
-  return tuple_forEachField(dest, src, metatype,
-                            &ValueWitnessTable::assignWithTake);
+
+  tuple_assignWithTakeWithLayout((char*) dest, (char*) src,
+                                 tuple_getLayoutString(metatype),
+                                 tuple_getValueWitnesses(metatype)->size);
+  return dest;
 }
 
 /// Generic tuple value witness for 'initializeBufferWithCopy'.
@@ -1002,7 +1300,14 @@ swift::swift_getTupleTypeMetadata(size_t numElements,
 
   // Search the cache.
   TupleCacheEntry::Key key = { numElements, elements, labels };
-  return &TupleTypes.getOrInsert(key, proposedWitnesses).first->Data;
+  uint64_t traceStart = isStartupTraceEnabled() ? getStartupTraceTime() : 0;
+  auto result = TupleTypes.getOrInsert(key, proposedWitnesses);
+  if (traceStart && result.second)
+    recordStartupTraceEvent(StartupTraceEventKind::MetadataInstantiation,
+                            traceStart, getStartupTraceTime(),
+                            static_cast<const Metadata *>(&result.first->Data),
+                            nullptr);
+  return &result.first->Data;
 }
 
 TupleCacheEntry::TupleCacheEntry(const Key &key,
@@ -1020,6 +1325,15 @@ TupleCacheEntry::TupleCacheEntry(const Key &key,
       Data.getElement(i).Offset = offset;
     });
 
+  // Build the layout string from the non-POD elements.
+  auto layoutOp = const_cast<TupleLayoutOp *>(tuple_getLayoutString(&Data));
+  for (size_t i = 0, e = key.NumElements; i != e; ++i) {
+    auto &elt = Data.getElement(i);
+    if (!elt.Type->getValueWitnesses()->isPOD())
+      *layoutOp++ = getTupleLayoutOp(elt.Type, elt.Offset);
+  }
+  *layoutOp = {TupleLayoutOp::End, 0, nullptr};
+
   Witnesses.size = layout.size;
   Witnesses.flags = layout.flags;
   Witnesses.stride = layout.stride;
@@ -2665,16 +2979,44 @@ namespace {
 using GenericWitnessTableCache = MetadataCache<WitnessTableCacheEntry>;
 using LazyGenericWitnessTableCache = Lazy<GenericWitnessTableCache>;
 
-/// Fetch the cache for a generic witness-table structure.
-static GenericWitnessTableCache &getCache(GenericWitnessTable *gen) {
+namespace {
+  /// The private data of a generic witness table.
+  ///
+  /// Most conformances are only ever instantiated for a handful of types,
+  /// so in front of the full cache we keep a small direct-mapped table of
+  /// recently returned entries. An entry is published with a single
+  /// pointer-sized store and its key lives in the entry itself, so the
+  /// table can be probed without taking a lock, hashing the key, or
+  /// writing to shared memory.
+  struct GenericWitnessTablePrivateData {
+    enum : size_t { NumRecentEntries = 4 };
+
+    LazyGenericWitnessTableCache Cache;
+    std::atomic<const WitnessTableCacheEntry *> RecentEntries[NumRecentEntries];
+
+    std::atomic<const WitnessTableCacheEntry *> &
+    getRecentEntrySlot(const Metadata *type) {
+      // Metadata is pointer-aligned, so the low bits carry no information.
+      auto index = (reinterpret_cast<uintptr_t>(type) >> 3)
+                     & (NumRecentEntries - 1);
+      return RecentEntries[index];
+    }
+  };
+}
+
+static GenericWitnessTablePrivateData &
+getPrivateData(GenericWitnessTable *gen) {
   // Keep this assert even if you change the representation above.
-  static_assert(sizeof(LazyGenericWitnessTableCache) <=
+  static_assert(sizeof(GenericWitnessTablePrivateData) <=
                 sizeof(GenericWitnessTable::PrivateData),
                 "metadata cache is larger than the allowed space");
 
-  auto lazyCache =
-    reinterpret_cast<LazyGenericWitnessTableCache*>(gen->PrivateData);
-  return lazyCache->get();
+  return *reinterpret_cast<GenericWitnessTablePrivateData*>(gen->PrivateData);
+}
+
+/// Fetch the cache for a generic witness-table structure.
+static GenericWitnessTableCache &getCache(GenericWitnessTable *gen) {
+  return getPrivateData(gen).Cache.get();
 }
 
 /// If there's no initializer, no private storage, and all requirements
@@ -2770,14 +3112,26 @@ swift::swift_getGenericWitnessTable(GenericWitnessTable *genericTable,
     return genericTable->Pattern;
   }
 
+  // Fast path: check whether we recently returned this table. This never
+  // allocates or takes the cache lock.
+  auto &privateData = getPrivateData(genericTable);
+  auto &recentEntry = privateData.getRecentEntrySlot(type);
+  if (auto entry = recentEntry.load(std::memory_order_acquire)) {
+    if (entry->getArgumentsBuffer()[0] == type)
+      return entry->get(genericTable);
+  }
+
   // If type is not nullptr, the witness table depends on the substituted
   // conforming type, so use that are the key.
   constexpr const size_t numGenericArgs = 1;
   const void *args[] = { type };
 
-  auto &cache = getCache(genericTable);
+  auto &cache = privateData.Cache.get();
   auto entry = cache.findOrAdd(args, numGenericArgs,
     [&]() -> WitnessTableCacheEntry* {
+      StartupTraceScope trace(StartupTraceEventKind::WitnessTableInstantiation,
+                              type);
+
       // Allocate the witness table and fill it in.
       auto entry = allocateWitnessTable(genericTable,
                                         cache.getAllocator(),
@@ -2793,6 +3147,10 @@ swift::swift_getGenericWitnessTable(GenericWitnessTable *genericTable,
       return entry;
     });
 
+  // Entries are never deallocated, so it is safe to publish this one for
+  // lock-free readers. Racing stores to the slot just pick a winner.
+  recentEntry.store(entry, std::memory_order_release);
+
   return entry->get(genericTable);
 }
 
@@ -15,6 +15,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "Private.h"
+#include "StartupTrace.h"
 #include "swift/Runtime/Once.h"
 #include "swift/Runtime/Debug.h"
 #include <type_traits>
@@ -35,10 +36,32 @@ static_assert(std::is_same<swift_once_t, dispatch_once_t>::value,
 static_assert(sizeof(swift_once_t) <= sizeof(void*),
               "swift_once_t must be no larger than the platform word");
 
+/// Runs an initializer on behalf of swift_once and records it in the
+/// startup trace.
+static void runTracedOnceInitializer(void *context) {
+  auto fn = reinterpret_cast<void (*)(void *)>(context);
+  StartupTraceScope trace(StartupTraceEventKind::OnceInitializer,
+                          reinterpret_cast<const void *>(fn));
+  fn(nullptr);
+}
+
 /// Runs the given function with the given context argument exactly once.
 /// The predicate argument must point to a global or static variable of static
 /// extent of type swift_once_t.
 void swift::swift_once(swift_once_t *predicate, void (*fn)(void *)) {
+  if (isStartupTraceEnabled()) {
+    auto context = reinterpret_cast<void *>(fn);
+#if defined(__APPLE__)
+    dispatch_once_f(predicate, context, runTracedOnceInitializer);
+#elif defined(__CYGWIN__)
+    _swift_once_f(predicate, context, runTracedOnceInitializer);
+#else
+    std::call_once(*predicate,
+                   [context]() { runTracedOnceInitializer(context); });
+#endif
+    return;
+  }
+
 #if defined(__APPLE__)
   dispatch_once_f(predicate, nullptr, fn);
 #elif defined(__CYGWIN__)
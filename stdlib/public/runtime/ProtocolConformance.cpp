@@ -21,6 +21,7 @@
 #include "swift/Runtime/Mutex.h"
 #include "ImageInspection.h"
 #include "Private.h"
+#include "StartupTrace.h"
 #include <dlfcn.h>
 
 using namespace swift;
@@ -442,6 +443,9 @@ recur:
   unsigned sectionIdx = foundEntry ? foundEntry->getFailureGeneration() : 0;
   unsigned endSectionIdx = C.SectionsToScan.size();
 
+  StartupTraceScope trace(StartupTraceEventKind::ConformanceScan, origType,
+                          protocol->Name);
+
   for (; sectionIdx < endSectionIdx; ++sectionIdx) {
     auto &section = C.SectionsToScan[sectionIdx];
     // Eagerly pull records for nondependent witnesses into our cache.
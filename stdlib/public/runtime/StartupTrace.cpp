@@ -0,0 +1,225 @@
+//===--- StartupTrace.cpp - Runtime startup tracing -----------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Recording and dumping of the runtime startup trace. See StartupTrace.h.
+//
+// Events are appended to a fixed-size buffer that is allocated when tracing
+// is enabled, so recording an event never takes a lock. Names are only
+// computed when the trace is written out at exit, which keeps the cost of
+// the instrumented operations close to what it is without tracing.
+//
+//===----------------------------------------------------------------------===//
+
+#include "StartupTrace.h"
+#include "swift/Basic/Demangle.h"
+#include "swift/Runtime/Metadata.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#if defined(_WIN32)
+#include <process.h>
+#define getpid _getpid
+#else
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+
+using namespace swift;
+
+namespace {
+
+/// A recorded event. Ready is set last, so that a trace written while other
+/// threads are still running only contains complete events.
+struct StartupTraceEvent {
+  std::atomic<bool> Ready;
+  StartupTraceEventKind Kind;
+  size_t Thread;
+  uint64_t StartNanos;
+  uint64_t EndNanos;
+  const void *Subject;
+  const char *Detail;
+};
+
+} // end anonymous namespace
+
+/// The maximum number of events to record. Later events are counted but
+/// dropped.
+static const size_t MaxStartupTraceEvents = 1 << 16;
+
+static StartupTraceEvent *StartupTraceEvents;
+static std::atomic<size_t> NumStartupTraceEvents;
+static const char *StartupTracePath;
+static uint64_t StartupTraceBeginNanos;
+
+uint64_t swift::getStartupTraceTime() {
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(
+           steady_clock::now().time_since_epoch()).count();
+}
+
+void swift::recordStartupTraceEvent(StartupTraceEventKind kind,
+                                    uint64_t startNanos, uint64_t endNanos,
+                                    const void *subject, const char *detail) {
+  size_t index = NumStartupTraceEvents.fetch_add(1, std::memory_order_relaxed);
+  if (index >= MaxStartupTraceEvents)
+    return;
+
+  auto &event = StartupTraceEvents[index];
+  event.Kind = kind;
+  event.Thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+  event.StartNanos = startNanos;
+  event.EndNanos = endNanos;
+  event.Subject = subject;
+  event.Detail = detail;
+  event.Ready.store(true, std::memory_order_release);
+}
+
+/// Append \p str to \p out as the contents of a JSON string.
+static void appendJSONEscaped(std::string &out, const std::string &str) {
+  for (char c : str) {
+    switch (c) {
+    case '"': out += "\\\""; break;
+    case '\\': out += "\\\\"; break;
+    case '\n': out += "\\n"; break;
+    case '\t': out += "\\t"; break;
+    default:
+      if ((unsigned char) c < 0x20) {
+        char buffer[8];
+        snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned) c);
+        out += buffer;
+      } else {
+        out += c;
+      }
+    }
+  }
+}
+
+static const char *getCategoryName(StartupTraceEventKind kind) {
+  switch (kind) {
+  case StartupTraceEventKind::ImageRegistration:
+    return "image";
+  case StartupTraceEventKind::ConformanceScan:
+    return "conformance";
+  case StartupTraceEventKind::MetadataInstantiation:
+    return "metadata";
+  case StartupTraceEventKind::WitnessTableInstantiation:
+    return "witness-table";
+  case StartupTraceEventKind::OnceInitializer:
+    return "once";
+  }
+  return "unknown";
+}
+
+static std::string getSymbolName(const void *address) {
+#if !defined(_WIN32)
+  Dl_info info;
+  if (dladdr(address, &info) && info.dli_sname)
+    return info.dli_sname;
+#endif
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%p", address);
+  return buffer;
+}
+
+/// Compute the display name of an event.
+static std::string getEventName(const StartupTraceEvent &event) {
+  auto metadata = static_cast<const Metadata *>(event.Subject);
+  switch (event.Kind) {
+  case StartupTraceEventKind::ImageRegistration:
+    return std::string("register ") +
+           static_cast<const char *>(event.Subject) + " in " + event.Detail;
+  case StartupTraceEventKind::ConformanceScan: {
+    std::string name = "scan conformances for " +
+      (metadata ? nameForMetadata(metadata) : std::string("<null>"));
+    if (event.Detail)
+      name += ": " + Demangle::demangleSymbolAsString(event.Detail,
+                                                      strlen(event.Detail));
+    return name;
+  }
+  case StartupTraceEventKind::MetadataInstantiation:
+    return "instantiate " +
+           (metadata ? nameForMetadata(metadata) : std::string("<null>"));
+  case StartupTraceEventKind::WitnessTableInstantiation:
+    return "instantiate witness table for " +
+           (metadata ? nameForMetadata(metadata) : std::string("<none>"));
+  case StartupTraceEventKind::OnceInitializer:
+    return "swift_once " + getSymbolName(event.Subject);
+  }
+  return "unknown";
+}
+
+/// Write the recorded events to the trace file.
+static void writeStartupTrace() {
+  FILE *file = fopen(StartupTracePath, "w");
+  if (!file) {
+    fprintf(stderr, "swift runtime: could not open startup trace file '%s'\n",
+            StartupTracePath);
+    return;
+  }
+
+  size_t numEvents = NumStartupTraceEvents.load(std::memory_order_relaxed);
+  size_t numRecorded = std::min(numEvents, MaxStartupTraceEvents);
+  int pid = (int) getpid();
+
+  fputs("{\"traceEvents\":[\n", file);
+  bool first = true;
+  std::string line;
+  for (size_t i = 0; i < numRecorded; ++i) {
+    auto &event = StartupTraceEvents[i];
+    if (!event.Ready.load(std::memory_order_acquire))
+      continue;
+
+    line.clear();
+    line += first ? "" : ",\n";
+    line += "{\"name\":\"";
+    appendJSONEscaped(line, getEventName(event));
+    line += "\",\"cat\":\"";
+    line += getCategoryName(event.Kind);
+    line += "\",\"ph\":\"X\"";
+
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer),
+             ",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%zu}",
+             (event.StartNanos - StartupTraceBeginNanos) / 1000.0,
+             (event.EndNanos - event.StartNanos) / 1000.0,
+             pid, event.Thread);
+    line += buffer;
+
+    fputs(line.c_str(), file);
+    first = false;
+  }
+  fprintf(file, "\n],\"otherData\":{\"droppedEvents\":%zu}}\n",
+          numEvents - numRecorded);
+  fclose(file);
+}
+
+bool swift::initializeStartupTrace() {
+  const char *path = getenv("SWIFT_RUNTIME_STARTUP_TRACE");
+  if (!path || !path[0])
+    return false;
+
+  StartupTraceEvents = static_cast<StartupTraceEvent *>(
+    calloc(MaxStartupTraceEvents, sizeof(StartupTraceEvent)));
+  if (!StartupTraceEvents)
+    return false;
+
+  StartupTracePath = path;
+  StartupTraceBeginNanos = getStartupTraceTime();
+  atexit(writeStartupTrace);
+  return true;
+}
@@ -0,0 +1,110 @@
+//===--- StartupTrace.h - Runtime startup tracing ---------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// An opt-in timeline of the work the runtime does lazily while a program
+// starts up: registering images, scanning conformance records,
+// instantiating metadata and witness tables, and running swift_once
+// initializers.
+//
+// Tracing is enabled by setting SWIFT_RUNTIME_STARTUP_TRACE to the path of
+// a file. When the process exits, the recorded events are written to that
+// file in the Chrome trace event format, which can be loaded into
+// chrome://tracing or any compatible viewer.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_RUNTIME_STARTUPTRACE_H
+#define SWIFT_RUNTIME_STARTUPTRACE_H
+
+#include <cstdint>
+
+namespace swift {
+
+/// The kinds of work recorded in the startup trace.
+enum class StartupTraceEventKind : uint8_t {
+  /// Registering a metadata section of a loaded image. The subject is the
+  /// name of the section's start symbol and the detail is the image path.
+  ImageRegistration,
+
+  /// Scanning newly registered conformance records for a type. The subject
+  /// is the type metadata and the detail is the mangled name of the
+  /// protocol.
+  ConformanceScan,
+
+  /// Instantiating generic, tuple or function type metadata. The subject is
+  /// the new metadata.
+  MetadataInstantiation,
+
+  /// Instantiating a generic or resilient witness table. The subject is the
+  /// conforming type metadata, if any.
+  WitnessTableInstantiation,
+
+  /// Running a swift_once initializer. The subject is the initializer
+  /// function.
+  OnceInitializer,
+};
+
+/// Initialize startup tracing from the environment. Returns true if it is
+/// enabled. Only called through isStartupTraceEnabled().
+bool initializeStartupTrace();
+
+/// Is startup tracing enabled for this process?
+inline bool isStartupTraceEnabled() {
+  static const bool enabled = initializeStartupTrace();
+  return enabled;
+}
+
+/// Record a completed event. Only valid when tracing is enabled.
+/// \p detail must remain valid until the process exits.
+void recordStartupTraceEvent(StartupTraceEventKind kind,
+                             uint64_t startNanos, uint64_t endNanos,
+                             const void *subject, const char *detail);
+
+/// Return the current time on the clock used for trace events.
+uint64_t getStartupTraceTime();
+
+/// Records an event covering the lifetime of this object, if tracing is
+/// enabled.
+class StartupTraceScope {
+  StartupTraceEventKind Kind;
+  bool Enabled;
+  uint64_t StartNanos;
+  const void *Subject;
+  const char *Detail;
+
+  StartupTraceScope(const StartupTraceScope &) = delete;
+  StartupTraceScope &operator=(const StartupTraceScope &) = delete;
+
+public:
+  explicit StartupTraceScope(StartupTraceEventKind kind,
+                             const void *subject = nullptr,
+                             const char *detail = nullptr)
+    : Kind(kind), Enabled(isStartupTraceEnabled()), StartNanos(0),
+      Subject(subject), Detail(detail) {
+    if (Enabled)
+      StartNanos = getStartupTraceTime();
+  }
+
+  /// Set the subject of the event once it is known, e.g. the metadata
+  /// that was just instantiated.
+  void setSubject(const void *subject) { Subject = subject; }
+
+  ~StartupTraceScope() {
+    if (Enabled)
+      recordStartupTraceEvent(Kind, StartNanos, getStartupTraceTime(),
+                              Subject, Detail);
+  }
+};
+
+} // end namespace swift
+
+#endif // SWIFT_RUNTIME_STARTUPTRACE_H
@@ -0,0 +1,35 @@
+// RUN: rm -rf %t && mkdir -p %t
+
+// The names computed while building the module are read back from its
+// lookup table by later compilations.
+// RUN: %target-swift-frontend(mock-sdk: %clang-importer-sdk) -typecheck -I %S/Inputs/custom-modules -module-cache-path %t/cache %s
+// RUN: %target-swift-frontend(mock-sdk: %clang-importer-sdk) -typecheck -I %S/Inputs/custom-modules -module-cache-path %t/cache -print-stats %s 2>&1 | %FileCheck -check-prefix=STATS %s
+
+// The names read back must be the same as the computed ones.
+// RUN: rm -rf %t/cache
+// RUN: %target-swift-ide-test(mock-sdk: %clang-importer-sdk) -print-module -source-filename %s -module-to-print=SwiftName -function-definitions=false -I %S/Inputs/custom-modules -module-cache-path %t/cache > %t/first.txt
+// RUN: %target-swift-ide-test(mock-sdk: %clang-importer-sdk) -print-module -source-filename %s -module-to-print=SwiftName -function-definitions=false -I %S/Inputs/custom-modules -module-cache-path %t/cache > %t/second.txt
+// RUN: diff -u %t/first.txt %t/second.txt
+// RUN: %FileCheck -check-prefix=PRINT %s < %t/second.txt
+
+// REQUIRES: asserts
+// REQUIRES: objc_interop
+
+// STATS: {{[0-9]+}} Import Name {{.*}} # of import names found in a module's serialized lookup table
+
+// PRINT: func drawString(_: UnsafePointer<Int8>!, x: Int32, y: Int32)
+// PRINT: struct ColorKind
+// PRINT: struct Point
+// PRINT: typealias MyInt = Int32
+// PRINT: func nicelyRenamedFunction(_: UnsafePointer<Int8>!)
+
+import SwiftName
+
+func test() {
+  drawString("hello", x: 1, y: 2)
+  let _: ColorKind = CT_red
+  let _: MyInt = 0
+  let p = Point(x: 1, y: 2)
+  _ = p.x
+  nicelyRenamedFunction("world")
+}
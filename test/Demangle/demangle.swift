@@ -9,6 +9,11 @@ RUN: sed -ne '/--->/s/^.*---> *//p' < %S/Inputs/manglings.txt > %t.check
 RUN: swift-demangle < %t.input > %t.output
 RUN: diff %t.check %t.output
 
+RUN: swift-demangle -bulk -j 4 < %t.input > %t.bulk-output
+RUN: diff %t.check %t.bulk-output
+RUN: swift-demangle -bulk -j 4 -input-file=%t.input > %t.bulk-file-output
+RUN: diff %t.check %t.bulk-file-output
+
 ; RUN: swift-demangle __TtSi | %FileCheck %s -check-prefix=DOUBLE
 ; DOUBLE: _TtSi ---> Swift.Int
 
@@ -22,6 +22,10 @@
 // CHECK: swift
 // CHECK: -profile-generate
 
+// RUN: %swiftc_driver -driver-print-jobs -profile-use=/path/to/default.profdata -target x86_64-unknown-linux-gnu %s | %FileCheck -check-prefix=USE %s
+// USE: swift
+// USE: -profile-use=/path/to/default.profdata
+
 // OSX: bin/ld{{"? }}
 // OSX: lib/swift/clang/lib/darwin/libclang_rt.profile_osx.a
 
@@ -0,0 +1,10 @@
+// RUN: %target-swift-ide-test -benchmark-lexing -benchmark-iterations=3 -source-filename %s | %FileCheck %s
+
+// CHECK: {{[0-9]+}} tokens, {{[0-9]+}} bytes
+// CHECK: lexed {{.*}} MB in {{.*}} s ({{.*}} MB/s)
+
+/* A block comment /* with a nested comment */ and some UTF-8: héllo wörld */
+func lexMe(_ x: Int) -> String {
+    let identifierWithDigits123 = x  // a line comment that is long enough to span several words
+    return "plain ASCII text \(identifierWithDigits123) and ünïcödé"
+}
@@ -0,0 +1,50 @@
+// RUN: %target-swift-frontend -assume-parsing-unqualified-ownership-sil -O -emit-ir -primary-file %s | %FileCheck %s
+// RUN: %target-swift-frontend -assume-parsing-unqualified-ownership-sil -O -emit-ir -primary-file %s | %FileCheck %s --check-prefix=CHECK-DEPENDENT
+// RUN: %target-swift-frontend -assume-parsing-unqualified-ownership-sil -O -disable-generic-metadata-prespecialization -emit-ir -primary-file %s | %FileCheck %s --check-prefix=CHECK-DISABLED
+
+// REQUIRES: CPU=x86_64
+
+// The layout of Wrapper<T> doesn't depend on T.
+public struct Wrapper<T> {
+  var pointer: UnsafeMutablePointer<T>
+  var count: Int
+}
+
+// The layout of Pair<T> does.
+public struct Pair<T> {
+  var first: T
+  var second: T
+}
+
+// The metadata of Wrapper<Int> is emitted statically, with the field type
+// vector slot after the generic arguments. The nominal type descriptor is
+// filled in by the runtime.
+// CHECK-LABEL: @_TMfGV34generic_metadata_prespecialization7WrapperSi_ = private global
+// CHECK-SAME: @_TWVV34generic_metadata_prespecialization7Wrapper
+// CHECK-SAME: i64 1, i64 0, %swift.type* null, i64 0, i64 8, %swift.type* @_TMSi, %swift.type** null
+
+// CHECK-DISABLED-NOT: @_TMfGV34generic_metadata_prespecialization7WrapperSi_
+// CHECK-DEPENDENT-NOT: @_TMfGV34generic_metadata_prespecialization4PairSi_
+
+public func wrapperType() -> Any.Type {
+  return Wrapper<Int>.self
+}
+
+public func pairType() -> Any.Type {
+  return Pair<Int>.self
+}
+
+// The accessor registers it with the runtime, passing its generic arguments
+// as the key of the cache.
+// CHECK-LABEL: define {{.*}} @_TMaGV34generic_metadata_prespecialization7WrapperSi_()
+// CHECK: call %swift.type* @swift_getPrespecializedGenericMetadata(%swift.type_pattern* {{.*}}@_TMPV34generic_metadata_prespecialization7Wrapper{{.*}}, i8* {{.*}}@_TMfGV34generic_metadata_prespecialization7WrapperSi_{{.*}}, %swift.type* {{.*}}@_TMfGV34generic_metadata_prespecialization7WrapperSi_
+// CHECK: ret
+
+// CHECK-DEPENDENT-LABEL: define {{.*}} @_TMaGV34generic_metadata_prespecialization4PairSi_()
+// CHECK-DEPENDENT-NOT: swift_getPrespecializedGenericMetadata
+// CHECK-DEPENDENT: call %swift.type* @_TMaV34generic_metadata_prespecialization4Pair
+// CHECK-DEPENDENT: ret
+
+// CHECK-DISABLED-LABEL: define {{.*}} @_TMaGV34generic_metadata_prespecialization7WrapperSi_()
+// CHECK-DISABLED-NOT: swift_getPrespecializedGenericMetadata
+// CHECK-DISABLED: ret
@@ -0,0 +1,47 @@
+// RUN: rm -rf %t && mkdir -p %t
+
+// RUN: echo "initial" >%t/log
+// RUN: %target-swift-frontend -assume-parsing-unqualified-ownership-sil -O -wmo %s %S/Inputs/simple.swift -module-name=test -c -o %t/a.o -disable-incremental-llvm-codegen -llvm-object-cache-path %t/cache -Xllvm -debug-only=irgen 2>>%t/log
+
+// CHECK-LABEL: initial
+// CHECK: a.o: MD5=[[TEST_MD5:[0-9a-f]+]]
+// CHECK: a.o: object cache miss
+
+// The same IR with a different output file is copied from the cache.
+
+// RUN: echo "other output" >>%t/log
+// RUN: %target-swift-frontend -assume-parsing-unqualified-ownership-sil -O -wmo %s %S/Inputs/simple.swift -module-name=test -c -o %t/b.o -disable-incremental-llvm-codegen -llvm-object-cache-path %t/cache -Xllvm -debug-only=irgen 2>>%t/log
+// RUN: cmp %t/a.o %t/b.o
+
+// CHECK-LABEL: other output
+// CHECK: b.o: MD5=[[TEST_MD5]]
+// CHECK: b.o: object cache hit
+
+// RUN: echo "file changed" >>%t/log
+// RUN: %target-swift-frontend -assume-parsing-unqualified-ownership-sil -O -wmo %s %S/Inputs/simple2.swift -module-name=test -c -o %t/b.o -disable-incremental-llvm-codegen -llvm-object-cache-path %t/cache -Xllvm -debug-only=irgen 2>>%t/log
+
+// CHECK-LABEL: file changed
+// CHECK: b.o: MD5=[[TEST2_MD5:[0-9a-f]+]]
+// CHECK: b.o: object cache miss
+
+// RUN: %FileCheck %s < %t/log
+
+// Both object files are in the cache.
+
+// RUN: ls %t/cache | %FileCheck -check-prefix=CACHE %s
+// CACHE: {{^[0-9a-f]+\.o$}}
+// CACHE: {{^[0-9a-f]+\.o$}}
+// CACHE-NOT: .tmp
+
+// With a size limit of zero, every object file is evicted when a new one is
+// added.
+
+// RUN: %target-swift-frontend -assume-parsing-unqualified-ownership-sil -O -wmo %s %S/Inputs/simple.swift -disable-llvm-optzns -module-name=test -c -o %t/c.o -disable-incremental-llvm-codegen -llvm-object-cache-path %t/cache -llvm-object-cache-size-limit 0
+// RUN: ls %t/cache | %FileCheck -check-prefix=EMPTY -allow-empty %s
+// EMPTY-NOT: .o
+
+// REQUIRES: asserts
+
+public func test_func1() {
+  print("Hello")
+}
@@ -370,6 +370,75 @@ bb1:
 }
 
 
+; CHECK-LABEL: @retain_release_across_diamond(
+; CHECK-NOT: swift_retain
+; CHECK-NOT: swift_release
+; CHECK: ret void
+define void @retain_release_across_diamond(%swift.refcounted* %A, i1 %c) {
+entry:
+  tail call void @swift_retain(%swift.refcounted* %A)
+  br i1 %c, label %bb1, label %bb2
+bb1:
+  %x = add i64 1, 2
+  br label %bb3
+bb2:
+  br label %bb3
+bb3:
+  tail call void @swift_release(%swift.refcounted* %A)
+  ret void
+}
+
+; CHECK-LABEL: @retains_in_predecessors(
+; CHECK-NOT: swift_retain
+; CHECK-NOT: swift_release
+; CHECK: ret void
+define void @retains_in_predecessors(%swift.refcounted* %A, i1 %c) {
+entry:
+  br i1 %c, label %bb1, label %bb2
+bb1:
+  tail call void @swift_retain(%swift.refcounted* %A)
+  br label %bb3
+bb2:
+  tail call void @swift_retain(%swift.refcounted* %A)
+  br label %bb3
+bb3:
+  tail call void @swift_release(%swift.refcounted* %A)
+  ret void
+}
+
+; The retain is not paired on the path through bb2.
+; CHECK-LABEL: @retain_release_not_on_all_paths(
+; CHECK: swift_retain
+; CHECK: swift_release
+; CHECK: ret void
+define void @retain_release_not_on_all_paths(%swift.refcounted* %A, i1 %c) {
+entry:
+  tail call void @swift_retain(%swift.refcounted* %A)
+  br i1 %c, label %bb1, label %bb2
+bb1:
+  tail call void @swift_release(%swift.refcounted* %A)
+  br label %bb2
+bb2:
+  ret void
+}
+
+; CHECK-LABEL: @retain_release_across_user(
+; CHECK: swift_retain
+; CHECK: call void @unknown_func()
+; CHECK: swift_release
+; CHECK: ret void
+define void @retain_release_across_user(%swift.refcounted* %A, i1 %c) {
+entry:
+  tail call void @swift_retain(%swift.refcounted* %A)
+  br i1 %c, label %bb1, label %bb2
+bb1:
+  call void @unknown_func()
+  br label %bb2
+bb2:
+  tail call void @swift_release(%swift.refcounted* %A)
+  ret void
+}
+
 !llvm.dbg.cu = !{!1}
 !llvm.module.flags = !{!4}
 
@@ -0,0 +1,48 @@
+// RUN: rm -rf %t
+// RUN: mkdir -p %t
+// RUN: %target-build-swift -Onone -module-name StartupTrace %s -o %t/a.out
+// RUN: env SWIFT_RUNTIME_STARTUP_TRACE=%t/trace.json %target-run %t/a.out | %FileCheck %s --check-prefix=CHECK-OUTPUT
+// RUN: %FileCheck %s < %t/trace.json
+
+// Section registration is only traced for ELF images.
+// REQUIRES: executable_test
+// REQUIRES: OS=linux-gnu
+
+// CHECK: {"traceEvents":[
+// CHECK-DAG: {"name":"register .swift2_protocol_conformances_start in {{.*}}","cat":"image","ph":"X","ts":{{[0-9.]+}},"dur":{{[0-9.]+}},"pid":{{[0-9]+}},"tid":{{[0-9]+}}}
+// CHECK-DAG: {"name":"scan conformances for StartupTrace.Box<Swift.Int>: StartupTrace.Describable","cat":"conformance"
+// CHECK-DAG: {"name":"instantiate StartupTrace.Box<Swift.Int>","cat":"metadata"
+// CHECK-DAG: {"name":"instantiate (Swift.Int, Swift.String)","cat":"metadata"
+// CHECK-DAG: {"name":"swift_once {{.*}}","cat":"once"
+// CHECK: ],"otherData":{"droppedEvents":0}}
+
+protocol Describable {
+  func describe() -> String
+}
+
+struct Box<T> {
+  var value: T
+}
+
+enum Settings {
+  static let greeting = "hello"
+}
+
+@inline(never)
+func typeName<T>(_ type: T.Type) -> String {
+  return "\(type)"
+}
+
+@inline(never)
+func isDescribable(_ value: Any) -> Bool {
+  return value is Describable
+}
+
+// CHECK-OUTPUT: Box<Int>
+print(typeName(Box<Int>.self))
+// CHECK-OUTPUT: (Int, String)
+print(typeName((Int, String).self))
+// CHECK-OUTPUT: false
+print(isDescribable(Box(value: 1)))
+// CHECK-OUTPUT: hello
+print(Settings.greeting)
@@ -0,0 +1,23 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %llvm-profdata merge %S/Inputs/pgo_use.proftext -o %t/pgo_use.profdata
+// RUN: %target-swift-frontend -parse-as-library -module-name pgo -emit-silgen -profile-use=%t/pgo_use.profdata %s | %FileCheck %s -check-prefix=SIL
+// RUN: %target-swift-frontend -parse-as-library -module-name pgo -emit-ir -profile-use=%t/pgo_use.profdata %s | %FileCheck %s -check-prefix=IR
+// RUN: not %target-swift-frontend -parse-as-library -emit-silgen -profile-use=%t/missing.profdata %s 2>&1 | %FileCheck %s -check-prefix=MISSING
+
+// MISSING: error: failed to load profile data '{{.*}}missing.profdata'
+
+// SIL-LABEL: sil @_TF3pgo6branchFSbSi
+// SIL: bb0(%0 : $Bool):{{ +}}// count: 100
+// SIL-NOT: builtin "int_instrprof_increment"
+// SIL: cond_br {{%[0-9]+}}, [[THEN:bb[0-9]+]], [[ELSE:bb[0-9]+]]
+// SIL: [[THEN]]:{{ +}}// Preds: bb0{{ +}}// count: 0
+
+// IR-LABEL: define {{.*}} @_TF3pgo6branchFSbSi
+// IR: br i1 {{%[0-9]+}}, label {{%[0-9]+}}, label {{%[0-9]+}}, !prof [[WEIGHTS:![0-9]+]]
+// IR: [[WEIGHTS]] = !{!"branch_weights", i32 1, i32 101}
+public func branch(_ b: Bool) -> Int {
+  if b {
+    return 1
+  }
+  return 0
+}
@@ -0,0 +1,4 @@
+@inline(never)
+public func genericFunc<T>(_ t: T) -> T {
+  return t
+}
@@ -0,0 +1,48 @@
+// RUN: %target-swift-frontend -O -wmo -whole-program -emit-sil %s | %FileCheck %s
+// RUN: %target-swift-frontend -O -wmo -emit-sil %s | %FileCheck -check-prefix=CHECK-MODULE %s
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: not %target-swift-frontend -O -wmo -whole-program -emit-module -emit-module-path %t/Lib.swiftmodule %s 2>&1 | %FileCheck -check-prefix=CHECK-EMIT-MODULE %s
+// RUN: not %target-swift-frontend -O -wmo -whole-program -parse-as-library -emit-sil %s 2>&1 | %FileCheck -check-prefix=CHECK-LIBRARY %s
+
+// CHECK-EMIT-MODULE: error: -whole-program can only be used when compiling an executable; it cannot be combined with emitting a module
+// CHECK-LIBRARY: error: -whole-program can only be used when compiling an executable; it cannot be combined with -parse-as-library
+
+// With -whole-program no other module can subclass the open classes of this
+// module, so calls of open methods can be devirtualized without guards.
+
+open class Base {
+  @inline(never)
+  open func foo() -> Int { return 1 }
+}
+
+open class Derived : Base {
+}
+
+// CHECK-LABEL: sil @_TF20devirt_whole_program7callFooFCS_4BaseSi
+// CHECK-NOT: class_method
+// CHECK-NOT: checked_cast_br
+// CHECK: function_ref @_TFC20devirt_whole_program4Base3foofT_Si
+// CHECK-NOT: class_method
+// CHECK: return
+// CHECK-MODULE-LABEL: sil @_TF20devirt_whole_program7callFooFCS_4BaseSi
+// CHECK-MODULE: class_method
+// CHECK-MODULE: return
+public func callFoo(_ b: Base) -> Int {
+  return b.foo()
+}
+
+open class Leaf {
+  @inline(never)
+  open func bar() -> Int { return 2 }
+}
+
+// CHECK-LABEL: sil @_TF20devirt_whole_program7callBarFCS_4LeafSi
+// CHECK-NOT: class_method
+// CHECK-NOT: checked_cast_br
+// CHECK: return
+// CHECK-MODULE-LABEL: sil @_TF20devirt_whole_program7callBarFCS_4LeafSi
+// CHECK-MODULE: class_method
+// CHECK-MODULE: return
+public func callBar(_ l: Leaf) -> Int {
+  return l.bar()
+}
@@ -0,0 +1,22 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %llvm-profdata merge %S/Inputs/pgo_generic_specializer.proftext -o %t/pgo.profdata
+// RUN: %target-swift-frontend -parse-as-library -module-name pgo -O -emit-sil -profile-use=%t/pgo.profdata %s | %FileCheck %s
+
+// The "then" block of the if-statement was never executed, so ColdBlockInfo
+// treats it as cold and the call in it is not specialized.
+
+@inline(never)
+public func generic<T>(_ x: T) -> T {
+  return x
+}
+
+// CHECK-LABEL: sil @_TF3pgo6callerFSbSi
+// CHECK-DAG: function_ref @_TTSg5Si___TF3pgo7generic
+// CHECK-DAG: function_ref @_TF3pgo7generic
+// CHECK: } // end sil function '_TF3pgo6callerFSbSi'
+public func caller(_ b: Bool) -> Int {
+  if b {
+    return generic(1)
+  }
+  return generic(2)
+}
@@ -0,0 +1,31 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %llvm-profdata merge %S/Inputs/pgo_inliner.proftext -o %t/pgo.profdata
+// RUN: %target-swift-frontend -parse-as-library -module-name pgo -O -emit-sil -profile-use=%t/pgo.profdata %s > %t/out.sil
+// RUN: %FileCheck %s -check-prefix=HOT < %t/out.sil
+// RUN: %FileCheck %s -check-prefix=COLD < %t/out.sil
+
+// hot and cold have the same body. The profile says cold never ran, so only
+// trivial callees are inlined into it.
+
+public func double(_ x: Int) -> Int {
+  return x &* 2
+}
+
+public func callEightTimes(_ f: (Int) -> Int, _ x: Int) -> Int {
+  return f(x) &+ f(x &+ 1) &+ f(x &+ 2) &+ f(x &+ 3) &+
+         f(x &+ 4) &+ f(x &+ 5) &+ f(x &+ 6) &+ f(x &+ 7)
+}
+
+// HOT-LABEL: sil @_TF3pgo3hotFSiSi
+// HOT-NOT: function_ref @{{.*}}14callEightTimes
+// HOT: } // end sil function '_TF3pgo3hotFSiSi'
+public func hot(_ x: Int) -> Int {
+  return callEightTimes(double, x)
+}
+
+// COLD-LABEL: sil @_TF3pgo4coldFSiSi
+// COLD: function_ref @{{.*}}14callEightTimes
+// COLD: } // end sil function '_TF3pgo4coldFSiSi'
+public func cold(_ x: Int) -> Int {
+  return callEightTimes(double, x)
+}
@@ -0,0 +1,32 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %llvm-profdata merge %S/Inputs/pgo_speculative_devirt.proftext -o %t/pgo.profdata
+// RUN: %target-swift-frontend -parse-as-library -module-name pgo -O -emit-sil -profile-use=%t/pgo.profdata %s > %t/out.sil
+// RUN: %FileCheck %s -check-prefix=HOT < %t/out.sil
+// RUN: %FileCheck %s -check-prefix=COLD < %t/out.sil
+
+// The profile says cold never ran, so its class_method call is not
+// speculatively devirtualized.
+
+public class Base {
+  public func value() -> Int { return 1 }
+}
+
+public class Derived : Base {
+  public override func value() -> Int { return 2 }
+}
+
+// HOT-LABEL: sil @_TF3pgo3hotFCS_4BaseSi
+// HOT: checked_cast_br [exact]
+// HOT: } // end sil function '_TF3pgo3hotFCS_4BaseSi'
+public func hot(_ b: Base) -> Int {
+  return b.value()
+}
+
+// COLD-LABEL: sil @_TF3pgo4coldFCS_4BaseSi
+// COLD-NOT: checked_cast_br
+// COLD: class_method
+// COLD-NOT: checked_cast_br
+// COLD: } // end sil function '_TF3pgo4coldFCS_4BaseSi'
+public func cold(_ b: Base) -> Int {
+  return b.value()
+}
@@ -0,0 +1,30 @@
+// RUN: %target-swift-frontend -parse-as-library -prespecialization-manifest %S/Inputs/prespecialization_manifest.txt -emit-silgen %s | %FileCheck %s --check-prefix=SILGEN
+// RUN: %target-swift-frontend -parse-as-library -prespecialization-manifest %S/Inputs/prespecialization_manifest.txt -O -emit-sil %s | %FileCheck %s --check-prefix=OPT
+
+// Check that functions listed in a prespecialization manifest get the same
+// specializations as functions with an explicit @_specialize attribute.
+
+// SILGEN-LABEL: sil [noinline] [_specialize <Int>] @_TF25prespecialization_manifest11genericFunc
+@inline(never)
+public func genericFunc<T>(_ t: T) -> T {
+  return t
+}
+
+public struct Container {
+  // SILGEN-LABEL: sil [noinline] [_specialize <Double>] @_TFV25prespecialization_manifest9Container10getElement
+  @inline(never)
+  public func getElement<T>(_ t: T) -> T {
+    return t
+  }
+}
+
+// Functions which are not listed don't get specializations.
+// SILGEN-LABEL: sil [noinline] @_TF25prespecialization_manifest12unlistedFunc
+@inline(never)
+public func unlistedFunc<T>(_ t: T) -> T {
+  return t
+}
+
+// The specializations of public functions are exported.
+// OPT-DAG: sil @_TTSg5Si___TF25prespecialization_manifest11genericFunc
+// OPT-DAG: sil @_TTSg5Sd___TFV25prespecialization_manifest9Container10getElement
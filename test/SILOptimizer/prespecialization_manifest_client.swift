@@ -0,0 +1,27 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %target-swift-frontend -O -parse-as-library -module-name PrespecializedLib -prespecialization-manifest %S/Inputs/prespecialized_lib_manifest.txt %S/Inputs/prespecialized_lib.swift -emit-module-path %t/PrespecializedLib.swiftmodule
+// RUN: %target-swift-frontend -Onone -I %t -emit-sil %s | %FileCheck %s
+
+// Check that an -Onone client calls the specialization which a library
+// exports because of its prespecialization manifest. The body of the
+// specialization is not serialized, only its declaration.
+
+import PrespecializedLib
+
+// CHECK-LABEL: sil @_TF33prespecialization_manifest_client7testInt
+// CHECK: function_ref @_TTSg5Si___TF17PrespecializedLib11genericFunc
+// CHECK: return
+public func testInt(_ x: Int) -> Int {
+  return genericFunc(x)
+}
+
+// Types which are not listed in the manifest still call the generic function.
+// CHECK-LABEL: sil @_TF33prespecialization_manifest_client10testDouble
+// CHECK: function_ref @_TF17PrespecializedLib11genericFunc
+// CHECK: return
+public func testDouble(_ x: Double) -> Double {
+  return genericFunc(x)
+}
+
+// The specialization is only a declaration in the client.
+// CHECK: sil {{.*}}@_TTSg5Si___TF17PrespecializedLib11genericFunc{{[^ ]*}} : $@convention(thin) {{[^{]*}}$
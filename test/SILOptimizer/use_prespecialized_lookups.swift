@@ -0,0 +1,21 @@
+// RUN: %target-swift-frontend -Onone -emit-sil -Xllvm -stats %s 2>&1 | %FileCheck %s
+
+// REQUIRES: asserts
+
+// At -Onone, calls of generic functions defined in this module are not looked
+// up in the imported modules: only the defining module exports
+// specializations.
+
+// CHECK-DAG: {{[0-9]+}} use-prespecialized {{.*}} Number of specializations looked up in imported modules
+// CHECK-DAG: 2 use-prespecialized {{.*}} Number of lookups skipped for specializations of local functions
+
+@inline(never)
+func localGeneric<T>(_ t: T) -> T {
+  return t
+}
+
+public func test(_ a: [Int]) -> Int {
+  let x = localGeneric(a.count)
+  let y = localGeneric(Double(x))
+  return a.index(after: Int(y))
+}
@@ -38,6 +38,7 @@
 #include "swift/IDE/REPLCodeCompletion.h"
 #include "swift/IDE/SyntaxModel.h"
 #include "swift/IDE/Utils.h"
+#include "swift/Parse/Lexer.h"
 #include "swift/Sema/IDETypeChecking.h"
 #include "swift/Markup/Markup.h"
 #include "swift/Config.h"
@@ -48,6 +49,7 @@
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/PrettyStackTrace.h"
@@ -56,6 +58,7 @@
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/ManagedStatic.h"
+#include <chrono>
 #include <system_error>
 
 #include <string>
@@ -72,6 +75,7 @@ enum class ActionType {
   DumpCompletionCache,
   DumpImporterLookupTable,
   SyntaxColoring,
+  BenchmarkLexing,
   DumpComments,
   Structure,
   Annotation,
@@ -153,6 +157,8 @@ Action(llvm::cl::desc("Mode:"), llvm::cl::init(ActionType::None),
                       "dump-importer-lookup-table", "Dump the Clang importer's lookup tables"),
            clEnumValN(ActionType::SyntaxColoring,
                       "syntax-coloring", "Perform syntax coloring"),
+           clEnumValN(ActionType::BenchmarkLexing,
+                      "benchmark-lexing", "Lex the source file repeatedly and report the throughput"),
            clEnumValN(ActionType::DumpComments,
                      "dump-comments", "Dump documentation comments attached to decls"),
            clEnumValN(ActionType::Structure,
@@ -260,6 +266,12 @@ ResourceDir("resource-dir",
 static llvm::cl::opt<std::string>
 ImportObjCHeader("import-objc-header", llvm::cl::desc("header to implicitly import"));
 
+static llvm::cl::opt<unsigned>
+BenchmarkIterations("benchmark-iterations",
+                    llvm::cl::desc("Number of times to lex the file in "
+                                   "-benchmark-lexing mode"),
+                    llvm::cl::init(10));
+
 static llvm::cl::opt<bool>
 EnableSourceImport("enable-source-import", llvm::cl::Hidden,
                    llvm::cl::init(false));
@@ -873,6 +885,45 @@ static int doSyntaxColoring(const CompilerInvocation &InitInvok,
   return 0;
 }
 
+static int doBenchmarkLexing(const CompilerInvocation &InitInvok,
+                             StringRef SourceFilename,
+                             unsigned Iterations) {
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> FileBufOrErr =
+    llvm::MemoryBuffer::getFile(SourceFilename);
+  if (!FileBufOrErr) {
+    llvm::errs() << "error opening input file: "
+                 << FileBufOrErr.getError().message() << '\n';
+    return 1;
+  }
+  size_t BufferSize = FileBufOrErr.get()->getBufferSize();
+
+  SourceManager SM;
+  unsigned BufferID = SM.addNewSourceBuffer(std::move(FileBufOrErr.get()));
+  const LangOptions &LangOpts = InitInvok.getLangOptions();
+
+  unsigned NumTokens = 0;
+  auto StartTime = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i != Iterations; ++i) {
+    Lexer L(LangOpts, SM, BufferID, /*Diags=*/nullptr, /*InSILMode=*/false,
+            CommentRetentionMode::AttachToNextToken);
+    Token Tok;
+    NumTokens = 0;
+    do {
+      L.lex(Tok);
+      ++NumTokens;
+    } while (Tok.isNot(tok::eof));
+  }
+  std::chrono::duration<double> Elapsed =
+      std::chrono::steady_clock::now() - StartTime;
+
+  double Megabytes = double(BufferSize) * Iterations / (1024.0 * 1024.0);
+  llvm::outs() << NumTokens << " tokens, " << BufferSize << " bytes\n";
+  llvm::outs() << llvm::format("lexed %.1f MB in %.3f s (%.1f MB/s)\n",
+                               Megabytes, Elapsed.count(),
+                               Megabytes / Elapsed.count());
+  return 0;
+}
+
 static int doDumpImporterLookupTables(const CompilerInvocation &InitInvok,
                                       StringRef SourceFilename) {
   if (options::ImportObjCHeader.empty()) {
@@ -2959,6 +3010,11 @@ int main(int argc, char *argv[]) {
                                 options::Playground);
     break;
 
+  case ActionType::BenchmarkLexing:
+    ExitCode = doBenchmarkLexing(InitInvok, options::SourceFilename,
+                                 options::BenchmarkIterations);
+    break;
+
   case ActionType::DumpImporterLookupTable:
     ExitCode = doDumpImporterLookupTables(InitInvok, options::SourceFilename);
     break;
@@ -0,0 +1,69 @@
+//===--- ClockCacheTest.cpp -----------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Basic/ClockCache.h"
+#include "gtest/gtest.h"
+
+using namespace swift;
+
+TEST(ClockCache, LookupAndInsert) {
+  ClockCache<unsigned, int> Cache(4);
+  EXPECT_EQ(nullptr, Cache.lookup(1));
+
+  Cache.insert(1, 10);
+  Cache.insert(2, 20);
+  ASSERT_NE(nullptr, Cache.lookup(1));
+  EXPECT_EQ(10, *Cache.lookup(1));
+  EXPECT_EQ(20, *Cache.lookup(2));
+
+  // Inserting an existing key replaces the value.
+  Cache.insert(1, 11);
+  EXPECT_EQ(11, *Cache.lookup(1));
+  EXPECT_EQ(2u, Cache.size());
+
+  EXPECT_EQ(4u, Cache.getNumHits());
+  EXPECT_EQ(1u, Cache.getNumMisses());
+  EXPECT_EQ(0u, Cache.getNumEvictions());
+}
+
+TEST(ClockCache, EvictsUnreferencedEntries) {
+  ClockCache<unsigned, int> Cache(3);
+  Cache.insert(1, 10);
+  Cache.insert(2, 20);
+  Cache.insert(3, 30);
+
+  // Entries 1 and 3 get a second chance, so 2 is evicted.
+  Cache.lookup(1);
+  Cache.lookup(3);
+  Cache.insert(4, 40);
+  EXPECT_EQ(3u, Cache.size());
+  EXPECT_EQ(1u, Cache.getNumEvictions());
+  EXPECT_EQ(nullptr, Cache.lookup(2));
+  EXPECT_EQ(10, *Cache.lookup(1));
+  EXPECT_EQ(30, *Cache.lookup(3));
+  EXPECT_EQ(40, *Cache.lookup(4));
+}
+
+TEST(ClockCache, StaysBounded) {
+  ClockCache<unsigned, unsigned> Cache(16);
+  for (unsigned i = 0; i < 1000; ++i) {
+    Cache.insert(i, i * 2);
+    EXPECT_LE(Cache.size(), 16u);
+    ASSERT_NE(nullptr, Cache.lookup(i));
+    EXPECT_EQ(i * 2, *Cache.lookup(i));
+  }
+  EXPECT_EQ(1000u - 16u, Cache.getNumEvictions());
+
+  Cache.clear();
+  EXPECT_EQ(0u, Cache.size());
+  EXPECT_EQ(nullptr, Cache.lookup(999));
+}
@@ -11,3 +11,29 @@ TEST(Demangle, DemangleWrappers) {
       demangleSymbolAsString(MangledName));
 }
 
+
+TEST(Demangle, NodeArena) {
+  const char *MangledNames[] = {
+    "_TtGSqGSaC5sugar7MyClass__",
+    "_TFSqcfT_GSqx_",
+    "_TTRXFo_dSi_dGSqSi__XFo_iSi_iGSqSi__",
+    "_TtBv4Bf16_",
+    "_TtV1a1b",
+  };
+
+  // Demangling into an arena that is reused for every symbol must produce
+  // the same trees as demangling onto the heap.
+  NodeArena Arena;
+  for (int Iteration = 0; Iteration < 2; ++Iteration) {
+    for (const char *Name : MangledNames) {
+      std::string Expected =
+          swift::Demangle::nodeToString(demangleSymbolAsNode(Name));
+      {
+        NodePointer Root = demangleSymbolAsNode(Name, Arena);
+        ASSERT_TRUE(Root != nullptr);
+        EXPECT_EQ(Expected, swift::Demangle::nodeToString(Root));
+      }
+      Arena.reset();
+    }
+  }
+}
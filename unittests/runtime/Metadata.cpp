@@ -10,9 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "swift/Runtime/HeapObject.h"
 #include "swift/Runtime/Metadata.h"
 #include "swift/Runtime/Concurrent.h"
 #include "gtest/gtest.h"
+#include <cstring>
+#include <atomic>
 #include <iterator>
 #include <functional>
 #include <sys/mman.h>
@@ -290,6 +293,48 @@ TEST(MetadataTest, getGenericMetadata) {
     });
 }
 
+/// Statically emitted instantiations of MetadataTest1.
+struct PrespecializedMetadataTest {
+  StructMetadata Metadata;
+  const void *GenericArgs[1];
+};
+
+PrespecializedMetadataTest PrespecializedMetadataTest1 = {
+  { MetadataKind::Struct, nullptr, nullptr },
+  { &Global1 }
+};
+
+PrespecializedMetadataTest PrespecializedMetadataTest2 = {
+  { MetadataKind::Struct, nullptr, nullptr },
+  { &Global2 }
+};
+
+TEST(MetadataTest, getPrespecializedGenericMetadata) {
+  auto metadataTemplate = (GenericMetadata*) &MetadataTest1;
+
+  // The candidate is registered if there is no instantiation yet.
+  void *args[] = { &Global1 };
+  auto candidate = &PrespecializedMetadataTest1.Metadata;
+
+  auto result1 = RaceTest_ExpectEqual<const Metadata *>(
+    [&]() -> const Metadata * {
+      return swift_getPrespecializedGenericMetadata(metadataTemplate, args,
+                                                    candidate);
+    });
+
+  EXPECT_EQ(candidate, result1);
+  EXPECT_EQ((const NominalTypeDescriptor*)&Global1,
+            candidate->Description.get());
+  EXPECT_EQ(result1, swift_getGenericMetadata(metadataTemplate, args));
+
+  // Otherwise the existing instantiation is returned.
+  args[0] = &Global2;
+  auto instantiated = swift_getGenericMetadata(metadataTemplate, args);
+  auto result2 = swift_getPrespecializedGenericMetadata(metadataTemplate, args,
+                                        &PrespecializedMetadataTest2.Metadata);
+  EXPECT_EQ(instantiated, result2);
+}
+
 FullMetadata<ClassMetadata> MetadataTest2 = {
   { { nullptr }, { &_TWVBo } },
   { { { MetadataKind::Class } }, nullptr, /*rodata*/ 1,
@@ -398,6 +443,183 @@ static const ExistentialTypeMetadata *test_getExistentialMetadata(
                                           mutDescriptors.data());
 }
 
+static void destroyTupleTestObject(HeapObject *object) {
+  swift_deallocObject(object, sizeof(HeapObject), alignof(HeapObject) - 1);
+}
+
+static const FullMetadata<ClassMetadata> TupleTestObjectMetadata = {
+  { { &destroyTupleTestObject }, { &_TWVBo } },
+  { { { MetadataKind::Class } }, nullptr, /*rodata*/ 1,
+    ClassFlags::UsesSwift1Refcounting, nullptr, 0, 0, 0, 0, 0 }
+};
+
+TEST(MetadataTest, tupleValueWitnessesWithReferences) {
+  const Metadata *elts[] = { &_TMBo.base, &_TMBi64_.base, &_TMBo.base };
+  auto tuple = swift_getTupleTypeMetadata(3, elts, nullptr, nullptr);
+  auto witnesses = tuple->getValueWitnesses();
+  EXPECT_FALSE(witnesses->isPOD());
+
+  struct Element {
+    HeapObject *First;
+    int64_t Second;
+    HeapObject *Third;
+  };
+  EXPECT_EQ(sizeof(Element), witnesses->stride);
+
+  auto object = swift_allocObject(&TupleTestObjectMetadata,
+                                  sizeof(HeapObject),
+                                  alignof(HeapObject) - 1);
+  swift_retain_n(object, 3);
+  Element src[2] = { { object, 1, object }, { object, 2, object } };
+  EXPECT_EQ(4u, swift_retainCount(object));
+
+  Element dest[2];
+  witnesses->initializeArrayWithCopy((OpaqueValue *) dest,
+                                     (OpaqueValue *) src, 2, tuple);
+  EXPECT_EQ(8u, swift_retainCount(object));
+  EXPECT_EQ(1, dest[0].Second);
+  EXPECT_EQ(2, dest[1].Second);
+
+  witnesses->destroyArray((OpaqueValue *) dest, 2, tuple);
+  EXPECT_EQ(4u, swift_retainCount(object));
+
+  witnesses->assignWithTake((OpaqueValue *) &src[0],
+                            (OpaqueValue *) &src[1], tuple);
+  EXPECT_EQ(2u, swift_retainCount(object));
+  EXPECT_EQ(2, src[0].Second);
+
+  witnesses->destroy((OpaqueValue *) &src[0], tuple);
+}
+
+namespace {
+struct OrderTestElement {
+  HeapObject *First;
+  int64_t Second;
+  HeapObject *Third;
+};
+}
+
+/// The tuple which is being assigned to, and a copy of it for every object
+/// which was destroyed, in order.
+static OrderTestElement *OrderTestTuple;
+static std::vector<std::pair<HeapObject *, OrderTestElement>> OrderTestLog;
+
+static void destroyOrderTestObject(HeapObject *object) {
+  OrderTestLog.push_back({object, *OrderTestTuple});
+  swift_deallocObject(object, sizeof(HeapObject), alignof(HeapObject) - 1);
+}
+
+static const FullMetadata<ClassMetadata> OrderTestObjectMetadata = {
+  { { &destroyOrderTestObject }, { &_TWVBo } },
+  { { { MetadataKind::Class } }, nullptr, /*rodata*/ 1,
+    ClassFlags::UsesSwift1Refcounting, nullptr, 0, 0, 0, 0, 0 }
+};
+
+TEST(MetadataTest, tupleAssignWithTakeOrder) {
+  const Metadata *elts[] = { &_TMBo.base, &_TMBi64_.base, &_TMBo.base };
+  auto tuple = swift_getTupleTypeMetadata(3, elts, nullptr, nullptr);
+  auto witnesses = tuple->getValueWitnesses();
+
+  auto newObject = [] {
+    return swift_allocObject(&OrderTestObjectMetadata, sizeof(HeapObject),
+                             alignof(HeapObject) - 1);
+  };
+  HeapObject *oldFirst = newObject(), *oldThird = newObject();
+  HeapObject *newFirst = newObject(), *newThird = newObject();
+
+  OrderTestElement dest = { oldFirst, 1, oldThird };
+  OrderTestElement src = { newFirst, 2, newThird };
+  OrderTestTuple = &dest;
+  OrderTestLog.clear();
+
+  // Like the assignWithTake witnesses of the elements, the old value of an
+  // element is released after the element was assigned and before the next
+  // element is assigned.
+  witnesses->assignWithTake((OpaqueValue *) &dest, (OpaqueValue *) &src,
+                            tuple);
+  ASSERT_EQ(2u, OrderTestLog.size());
+  EXPECT_EQ(oldFirst, OrderTestLog[0].first);
+  EXPECT_EQ(newFirst, OrderTestLog[0].second.First);
+  EXPECT_EQ(1, OrderTestLog[0].second.Second);
+  EXPECT_EQ(oldThird, OrderTestLog[0].second.Third);
+  EXPECT_EQ(oldThird, OrderTestLog[1].first);
+  EXPECT_EQ(2, OrderTestLog[1].second.Second);
+  EXPECT_EQ(newThird, OrderTestLog[1].second.Third);
+
+  witnesses->destroy((OpaqueValue *) &dest, tuple);
+  EXPECT_EQ(4u, OrderTestLog.size());
+}
+
+/// Metadata for Swift.Int and Swift.String.
+extern "C" const Metadata _TMSi;
+extern "C" const Metadata _TMSS;
+
+// The tuple value witnesses retain and release the owner of a String
+// directly, at the offset given by the field offset vectors of String and
+// _StringCore. Check that the fields declared in StringCore.swift still have
+// the layout this relies on.
+TEST(MetadataTest, stringLayout) {
+  auto string = cast<StructMetadata>(&_TMSS);
+  auto &stringDescription = string->getDescription()->Struct;
+  ASSERT_EQ(1u, stringDescription.NumFields);
+  EXPECT_STREQ("_core", stringDescription.FieldNames.get());
+  EXPECT_EQ(0u, string->getFieldOffsets()[0]);
+
+  auto core = cast<StructMetadata>(string->getFieldTypes()[0].getType());
+  auto &coreDescription = core->getDescription()->Struct;
+  ASSERT_EQ(3u, coreDescription.NumFields);
+  const char *fieldName = coreDescription.FieldNames.get();
+  EXPECT_STREQ("_baseAddress", fieldName);
+  fieldName += strlen(fieldName) + 1;
+  EXPECT_STREQ("_countAndFlags", fieldName);
+  fieldName += strlen(fieldName) + 1;
+  EXPECT_STREQ("_owner", fieldName);
+  EXPECT_EQ(2 * sizeof(void*), core->getFieldOffsets()[2]);
+
+  auto fieldTypes = core->getFieldTypes();
+  EXPECT_TRUE(fieldTypes[0].getType()->getValueWitnesses()->isPOD());
+  EXPECT_TRUE(fieldTypes[1].getType()->getValueWitnesses()->isPOD());
+  EXPECT_FALSE(fieldTypes[2].isWeak());
+  EXPECT_EQ(MetadataKind::Optional, fieldTypes[2].getType()->getKind());
+}
+
+TEST(MetadataTest, tupleValueWitnessesWithString) {
+  const Metadata *elts[] = { &_TMSi, &_TMSS };
+  auto tuple = swift_getTupleTypeMetadata(2, elts, nullptr, nullptr);
+  auto witnesses = tuple->getValueWitnesses();
+
+  struct Element {
+    intptr_t First;
+    void *BaseAddress;
+    uintptr_t CountAndFlags;
+    HeapObject *Owner;
+  };
+  EXPECT_EQ(sizeof(Element), witnesses->size);
+
+  auto object = swift_allocObject(&TupleTestObjectMetadata,
+                                  sizeof(HeapObject),
+                                  alignof(HeapObject) - 1);
+  Element src = { 1, nullptr, 0, object };
+  Element dest;
+  witnesses->initializeWithCopy((OpaqueValue *) &dest, (OpaqueValue *) &src,
+                                tuple);
+  EXPECT_EQ(2u, swift_retainCount(object));
+  EXPECT_EQ(1, dest.First);
+  EXPECT_EQ(object, dest.Owner);
+
+  witnesses->destroy((OpaqueValue *) &dest, tuple);
+  EXPECT_EQ(1u, swift_retainCount(object));
+
+  // A String without an owner.
+  Element noOwner = { 2, nullptr, 0, nullptr };
+  witnesses->assignWithCopy((OpaqueValue *) &src, (OpaqueValue *) &noOwner,
+                            tuple);
+  EXPECT_EQ(2, src.First);
+  EXPECT_EQ(nullptr, src.Owner);
+
+  witnesses->destroy((OpaqueValue *) &src, tuple);
+}
+
 TEST(MetadataTest, getExistentialMetadata) {
   RaceTest_ExpectEqual<const ExistentialTypeMetadata *>(
     [&]() -> const ExistentialTypeMetadata * {
@@ -982,3 +1204,68 @@ TEST(WitnessTableTest, getGenericWitnessTable) {
       });
   }
 }
+
+// Tests for generic witness table instantiation keyed by the conforming
+// type, where many threads look up the same small set of types.
+
+static std::atomic<unsigned> numDependentInstantiations{0};
+
+static void dependentWitnessTableInstantiator(WitnessTable *instantiatedTable,
+                                              const Metadata *type,
+                                              void * const *instantiationArgs) {
+  ++numDependentInstantiations;
+
+  // Record the conforming type in the dynamically-computed witness.
+  ((void **) instantiatedTable)[2] = (void *) type;
+}
+
+GenericWitnessTableStorage tableStorage5;
+
+TEST(WitnessTableTest, getGenericWitnessTableManyTypes) {
+  tableStorage5.WitnessTableSizeInWords = 5;
+  tableStorage5.WitnessTablePrivateSizeInWords = 1;
+  initializeRelativePointer(&tableStorage5.Protocol, &testProtocol.descriptor);
+  initializeRelativePointer(&tableStorage5.Pattern, witnesses);
+  initializeRelativePointer(&tableStorage5.Instantiator,
+                            (const void *) dependentWitnessTableInstantiator);
+
+  GenericWitnessTable *table = reinterpret_cast<GenericWitnessTable *>(
+      &tableStorage5);
+
+  // More types than there are fast-path slots, so that lookups evict
+  // each other.
+  const Metadata *types[] = {
+    &_TMBi8_.base, &_TMBi16_.base, &_TMBi32_.base, &_TMBi64_.base,
+    &_TMBo.base, &_TMBb.base, &_TMBp.base, &_TMBB.base
+  };
+  const unsigned numTypes = sizeof(types) / sizeof(types[0]);
+
+  auto results = RaceTest<const WitnessTable *>(
+    [&]() -> const WitnessTable * {
+      const WitnessTable *firstTable = nullptr;
+      for (unsigned iteration = 0; iteration < 100; ++iteration) {
+        for (unsigned i = 0; i < numTypes; ++i) {
+          const WitnessTable *instantiatedTable =
+              swift_getGenericWitnessTable(table, types[i], nullptr);
+
+          EXPECT_NE(instantiatedTable, table->Pattern.get());
+          EXPECT_EQ(((void **) instantiatedTable)[-1], (void *) 0);
+          EXPECT_EQ(((void **) instantiatedTable)[2], (void *) types[i]);
+          EXPECT_EQ(((void **) instantiatedTable)[4], (void *) 567);
+
+          if (i == 0) {
+            if (firstTable)
+              EXPECT_EQ(firstTable, instantiatedTable);
+            firstTable = instantiatedTable;
+          }
+        }
+      }
+      return firstTable;
+    });
+
+  for (auto result : results)
+    EXPECT_EQ(results[0], result);
+
+  // Each type was instantiated exactly once.
+  EXPECT_EQ(numTypes, numDependentInstantiations.load());
+}